@@ -0,0 +1,175 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef BENCHMARK_DATA_DIR
+#define BENCHMARK_DATA_DIR "."
+#endif
+
+// Keeps a value the compiler would otherwise throw away with the code computing it: the value
+// is taken as an input of an empty asm statement, a read of a volatile copy elsewhere
+template <typename T>
+inline void keep(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile T sink;
+	sink = value;
+	static_cast<void>(sink);
+#endif
+}
+
+// A suite of benchmarks timed one after another. Every benchmark is a batch(count) doing count times
+// the items of work - calls of a function for the micro ones, simulated runs for the macro ones. The batch
+// grows until it takes minTime, then it is timed repetitions times; the median time per item is the result.
+// The table goes to std::cerr, the JSON report to --out FILE or std::cout:
+// { "suite", "compiler", "build", "time", "benchmarks": [ { "name", "iterations", "repetitions",
+// "ns_per_item", "min_ns_per_item", "items_per_second" } ] }, ns_per_item is the one to track between releases
+struct Benchmarks
+{
+	Benchmarks(const std::string& suite, int argc, char* argv[]) : suite(suite)
+	{
+		for (int arg = 1; arg < argc; ++arg)
+		{
+			const std::string option = argv[arg];
+			if (option == "--out" && arg + 1 < argc)
+				outPath = argv[++arg];
+			else if (option == "--filter" && arg + 1 < argc)
+				filter = argv[++arg];
+			else if (option == "--min-time" && arg + 1 < argc)
+				minTime = std::stod(argv[++arg]);
+			else if (option == "--repetitions" && arg + 1 < argc)
+				repetitions = std::max(1, std::stoi(argv[++arg]));
+			else if (option == "--data" && arg + 1 < argc)
+				dataDir = argv[++arg];
+			else if (option == "--threads" && arg + 1 < argc)
+				threads = static_cast<unsigned>(std::stoul(argv[++arg]));
+			else
+				std::cerr << "Unknown option: " << option
+					<< " (expected: --out FILE, --filter TEXT, --min-time SECONDS, --repetitions N, --data DIR, --threads N)" << std::endl;
+		}
+	}
+
+	// The input files: tides_data.txt and draft.txt
+	std::string data(const std::string& file) const { return dataDir + "/" + file; }
+	unsigned threadsCount() const { return threads; }
+
+	// Only the benchmarks with the text of --filter in their names are run
+	template <typename Batch>
+	void run(const std::string& name, Batch batch, size_t items = 1)
+	{
+		if (name.find(filter) == std::string::npos)
+			return;
+
+		size_t count = 1;
+		for (double elapsed = time(batch, count); elapsed < minTime; elapsed = time(batch, count))
+			count = std::max(count * 2, static_cast<size_t>(count * minTime / std::max(elapsed, 1e-9) * 1.2));
+
+		std::vector<double> perItem;
+		for (int repetition = 0; repetition < repetitions; ++repetition)
+			perItem.push_back(time(batch, count) * 1e9 / (count * items));
+		std::sort(perItem.begin(), perItem.end());
+		results.push_back(Result{ name, count * items, perItem[perItem.size() / 2], perItem.front() });
+
+		std::cerr << std::left << std::setw(48) << name << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+			<< results.back().nsPerItem << " ns" << std::setw(16) << std::setprecision(0) << 1e9 / results.back().nsPerItem << " /s"
+			<< std::setw(12) << count * items << " x" << repetitions << std::endl;
+	}
+
+	// Writes the report; returns the exit code of the benchmark
+	int report() const
+	{
+		std::ofstream file;
+		if (!outPath.empty())
+		{
+			file.open(outPath);
+			if (!file.is_open())
+			{
+				std::cerr << "Unable to write " << outPath << std::endl;
+				return 1;
+			}
+		}
+		std::ostream& out = outPath.empty() ? std::cout : file;
+
+		out << "{\n"
+			<< "  \"suite\": \"" << suite << "\",\n"
+			<< "  \"compiler\": \"" << compiler() << "\",\n"
+#ifdef NDEBUG
+			<< "  \"build\": \"release\",\n"
+#else
+			<< "  \"build\": \"debug\",\n"
+#endif
+			<< "  \"time\": \"" << now() << "\",\n"
+			<< "  \"benchmarks\": [";
+		for (size_t r = 0; r < results.size(); ++r)
+		{
+			const Result& result = results[r];
+			out << (r ? ",\n" : "\n") << std::setprecision(6)
+				<< "    { \"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+				<< ", \"repetitions\": " << repetitions
+				<< ", \"ns_per_item\": " << result.nsPerItem << ", \"min_ns_per_item\": " << result.minNsPerItem
+				<< ", \"items_per_second\": " << 1e9 / result.nsPerItem << " }";
+		}
+		out << "\n  ]\n}\n";
+		return out ? 0 : 1;
+	}
+
+private:
+	struct Result
+	{
+		std::string name;
+		size_t iterations;
+		double nsPerItem;
+		double minNsPerItem;
+	};
+
+	template <typename Batch>
+	static double time(Batch& batch, size_t count)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		batch(count);
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	static std::string compiler()
+	{
+		std::ostringstream name;
+#if defined(__clang__)
+		name << "clang " << __clang_major__ << "." << __clang_minor__ << "." << __clang_patchlevel__;
+#elif defined(__GNUC__)
+		name << "gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "." << __GNUC_PATCHLEVEL__;
+#elif defined(_MSC_VER)
+		name << "msvc " << _MSC_VER;
+#else
+		name << "unknown";
+#endif
+		return name.str();
+	}
+
+	static std::string now()
+	{
+		const std::time_t time = std::time(nullptr);
+		char text[32] = {};
+		std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&time));
+		return text;
+	}
+
+	std::string suite;
+	std::string outPath;
+	std::string filter;
+	double minTime = 0.2;
+	int repetitions = 5;
+	std::string dataDir = BENCHMARK_DATA_DIR;
+	unsigned threads = 1;
+	std::vector<Result> results;
+};
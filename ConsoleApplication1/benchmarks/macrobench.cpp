@@ -0,0 +1,127 @@
+﻿#include "benchmark.h"
+
+#include "tide.h"
+#include "simulation.h"
+#include "scenario.h"
+#include "sweep.h"
+
+// Whole runs as the sweep and the logged runs do them: items are simulated runs, so items_per_second is runs/second
+int main(int argc, char* argv[])
+{
+	Benchmarks benchmarks("macro", argc, argv);
+	try
+	{
+		TideData tideData;
+		if (!tideData.readFromFile(benchmarks.data("tides_data.txt")))
+			return 1;
+		const TideTable::ConstPtr tides = tideData.toTideTable(1.4f);
+		const ShipDraftTable::Ptr drafts = std::make_shared<ShipDraftTable>();
+		if (!drafts->readFromFile(benchmarks.data("draft.txt")))
+			return 1;
+
+		const Timestamp simulationTime = 30 * 24 * 60;
+		SweepPoint point;
+		point.tugsNum = 2;
+		point.bargesNum = 4;
+		point.intensity = 1500 / 60.f;
+		point.bargeCargo = 4400.f;
+		point.distance = 8.f;
+
+		// A run of the sweep: the simulation and the vessels are reused from the run before
+		const auto simulate = [&](Simulation<NullRecorder>& simulation, Fleet<NullRecorder>& fleet, const SweepPoint& point)
+		{
+			simulation.reset();
+			fleet.release();
+			for (auto& context : prepareContexts(fleet, point, drafts))
+				simulation.addContext(context);
+			simulation.setTides(tides);
+			simulation.distLoadToDrop = point.distance;
+			addTows(simulation, fleet, point.tugsNum);
+			return simulation.run(simulationTime);
+		};
+
+		benchmarks.run("Simulation<NullRecorder>::run (30 days)", [&](size_t count)
+		{
+			Simulation<NullRecorder> simulation;
+			Fleet<NullRecorder> fleet;
+			float sum = 0.f;
+			for (size_t run = 0; run < count; ++run)
+				sum += simulate(simulation, fleet, point);
+			keep(sum);
+		});
+
+		// The same with the phases timed as by --profile, the difference is the cost of the timers
+		benchmarks.run("Simulation<NullRecorder>::run (30 days, profiled)", [&](size_t count)
+		{
+			Simulation<NullRecorder> simulation;
+			Fleet<NullRecorder> fleet;
+			simulation.profiling = true;
+			float sum = 0.f;
+			for (size_t run = 0; run < count; ++run)
+				sum += simulate(simulation, fleet, point);
+			keep(sum);
+		});
+
+		// A logged run of a best point: everything is new and every event is kept, in memory or streamed
+		const auto logged = [&](auto recorder)
+		{
+			using Recorder = decltype(recorder);
+			return [&](size_t count)
+			{
+				float sum = 0.f;
+				for (size_t run = 0; run < count; ++run)
+				{
+					Fleet<Recorder> fleet;
+					Simulation<Recorder> simulation;
+					for (auto& context : prepareContexts(fleet, point, drafts))
+						simulation.addContext(context);
+					simulation.setTides(tides);
+					simulation.distLoadToDrop = point.distance;
+					addTows(simulation, fleet, point.tugsNum);
+					sum += simulation.run(simulationTime);
+				}
+				keep(sum);
+			};
+		};
+		benchmarks.run("Simulation<FullRecorder>::run (30 days)", logged(FullRecorder()));
+		benchmarks.run("Simulation<StreamRecorder>::run (30 days)", logged(StreamRecorder()));
+
+		// A fixed corner of the grid of main() without the cutoff, so every run is simulated to the end:
+		// 1 and 2 tugs, 2 and 4 barges, 4 barge cargos and 3 distances - 48 runs on --threads workers
+		std::vector<SweepPoint> points;
+		for (int tugsNum : { 1, 2 })
+			for (int bargesNum : { 2, 4 })
+				for (float bargeCargo = 3000.f; bargeCargo <= 6000.f; bargeCargo += 1000.f)
+					for (float distance : { 4.f, 8.f, 12.f })
+					{
+						SweepPoint sweepPoint = point;
+						sweepPoint.tugsNum = tugsNum;
+						sweepPoint.bargesNum = bargesNum;
+						sweepPoint.bargeCargo = bargeCargo;
+						sweepPoint.distance = distance;
+						points.push_back(sweepPoint);
+					}
+		const WorkStealingPool pool(benchmarks.threadsCount());
+		benchmarks.run("runSweep (48 points, " + std::to_string(pool.threadsCount()) + " thread(s))", [&](size_t count)
+		{
+			float sum = 0.f;
+			for (size_t sweep = 0; sweep < count; ++sweep)
+			{
+				const auto amounts = runSweep<float>(points, [&](const SweepPoint& sweepPoint, size_t)
+				{
+					thread_local Simulation<NullRecorder> simulation;
+					thread_local Fleet<NullRecorder> fleet;
+					return simulate(simulation, fleet, sweepPoint);
+				}, pool);
+				sum += amounts.back();
+			}
+			keep(sum);
+		}, points.size());
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << "Exception caught: " << ex.what() << std::endl;
+		return 1;
+	}
+	return benchmarks.report();
+}
@@ -0,0 +1,156 @@
+﻿#include "benchmark.h"
+
+#include "tide.h"
+#include "ship.h"
+#include "simulation.h"
+#include "scenario.h"
+
+#include <random>
+
+// The hot calls of a simulated step, on the tides and the drafts of the working directory
+int main(int argc, char* argv[])
+{
+	Benchmarks benchmarks("micro", argc, argv);
+	try
+	{
+		TideData tideData;
+		if (!tideData.readFromFile(benchmarks.data("tides_data.txt")))
+			return 1;
+		const TideTable::Ptr tides = tideData.toTideTable(1.4f);
+		const ShipDraftTable::Ptr drafts = std::make_shared<ShipDraftTable>();
+		if (!drafts->readFromFile(benchmarks.data("draft.txt")))
+			return 1;
+
+		// Every batch goes through the same queries, drawn once
+		const size_t queries = 4096;
+		std::default_random_engine engine(1);
+		const Timestamp period = tides->getPeriod();
+		std::uniform_int_distribution<Timestamp> anyTime(0, 3 * period);
+		std::vector<Timestamp> times(queries);
+		std::vector<float> tideDrafts(queries);
+		for (size_t q = 0; q < queries; ++q)
+		{
+			times[q] = anyTime(engine);
+			tideDrafts[q] = tides->draft(anyTime(engine)); // the tide gets that high some time
+		}
+		std::uniform_real_distribution<float> anyCargo(drafts->firstKey(), drafts->lastKey());
+		std::vector<float> cargos(queries);
+		for (auto& cargo : cargos)
+			cargo = anyCargo(engine);
+		std::vector<Timestamp> phases(queries);
+		for (size_t q = 0; q < queries; ++q)
+			phases[q] = times[q] % period;
+
+		benchmarks.run("TideTable::timeToPossibleDraft", [&](size_t count)
+		{
+			Timestamp sum = 0;
+			for (size_t i = 0; i < count; ++i)
+				sum += tides->timeToPossibleDraft(times[i % queries], tideDrafts[i % queries]);
+			keep(sum);
+		});
+
+		benchmarks.run("InterpolatedTable<float>::get (drafts)", [&](size_t count)
+		{
+			float sum = 0.f;
+			for (size_t i = 0; i < count; ++i)
+				sum += drafts->get(cargos[i % queries]);
+			keep(sum);
+		});
+
+		benchmarks.run("InterpolatedTable<Timestamp>::get (tides)", [&](size_t count)
+		{
+			float sum = 0.f;
+			for (size_t i = 0; i < count; ++i)
+				sum += tides->get(phases[i % queries]);
+			keep(sum);
+		});
+
+		benchmarks.run("InterpolatedTable<Timestamp>::get (tides, batch)", [&](size_t count)
+		{
+			std::vector<float> levels(queries);
+			float sum = 0.f;
+			for (size_t done = 0; done < count; done += queries)
+			{
+				const size_t batch = std::min(queries, count - done);
+				tides->get(phases.data(), levels.data(), batch);
+				sum += levels[batch - 1];
+			}
+			keep(sum);
+		});
+
+		// A loader of a 30-day run: a lock of 2 to 8 hours every 6 hours, asked at any time of the run
+		UsedResource<NullRecorder> loader;
+		const Timestamp runTime = 30 * 24 * 60;
+		std::uniform_int_distribution<Timestamp> lockDuration(2 * 60, 8 * 60);
+		for (Timestamp start = 0; start < runTime; start += 6 * 60)
+			loader.lock(start, lockDuration(engine), &loader.id);
+		std::uniform_int_distribution<Timestamp> runMoment(0, runTime);
+		std::vector<Timestamp> moments(queries);
+		for (auto& moment : moments)
+			moment = runMoment(engine);
+
+		benchmarks.run("UsedResource::timeToUnlock", [&](size_t count)
+		{
+			Timestamp sum = 0;
+			for (size_t i = 0; i < count; ++i)
+				sum += loader.timeToUnlock(moments[i % queries]);
+			keep(sum);
+		});
+
+		benchmarks.run("UsedResource::earliestFit", [&](size_t count)
+		{
+			Timestamp sum = 0;
+			for (size_t i = 0; i < count; ++i)
+				sum += loader.earliestFit(moments[i % queries], 3 * 60);
+			keep(sum);
+		});
+
+		// A barge of a run goes through a few thousand events; the log is started over after as many
+		const auto rememberStates = [&](auto& barge, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (i % queries == 0)
+					barge.clear();
+				barge.localTimer += 10;
+				barge.rememberState(static_cast<ShipBase::State>(i % 4), static_cast<ShipBase::Cause>(i % 8), 1.f);
+			}
+			keep(barge.timeSpent(ShipBase::State::LOADING));
+		};
+		Washtub<FullRecorder> loggedBarge(1);
+		Washtub<NullRecorder> countedBarge(1);
+		benchmarks.run("Ship<FullRecorder>::rememberState", [&](size_t count) { rememberStates(loggedBarge, count); });
+		benchmarks.run("Ship<NullRecorder>::rememberState", [&](size_t count) { rememberStates(countedBarge, count); });
+
+		// The per-cause counters took the place of grepHistory: the stats of a run come from them
+		SweepPoint point;
+		point.tugsNum = 2;
+		point.bargesNum = 4;
+		point.intensity = 1500 / 60.f;
+		point.bargeCargo = 4400.f;
+		point.distance = 8.f;
+		Fleet<FullRecorder> fleet;
+		Simulation<FullRecorder> simulation;
+		const auto contexts = prepareContexts(fleet, point, drafts);
+		for (auto& context : contexts)
+			simulation.addContext(context);
+		simulation.setTides(tides);
+		simulation.distLoadToDrop = point.distance;
+		addTows(simulation, fleet, point.tugsNum);
+		simulation.run(runTime);
+
+		benchmarks.run("Simulation::collectStats", [&](size_t count)
+		{
+			float sum = 0.f;
+			for (size_t i = 0; i < count; ++i)
+				sum += simulation.collectStats().lostWaitingTide;
+			keep(sum);
+		});
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << "Exception caught: " << ex.what() << std::endl;
+		return 1;
+	}
+	return benchmarks.report();
+}
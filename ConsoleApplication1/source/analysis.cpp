@@ -0,0 +1,245 @@
+﻿#include "stdafx.h"
+
+#include "analysis.h"
+
+#include <map>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+
+namespace
+{
+	// Calls visit(column, field) for the fields of the record in the order of the columns
+	template <typename Record, typename Visit>
+	void forEachColumn(Record& record, Visit visit)
+	{
+		visit(Column{ "Point", ColumnType::INT32 }, record.point);
+		visit(Column{ "Group", ColumnType::INT32 }, record.group);
+		visit(Column{ "Tugs", ColumnType::INT32 }, record.config.tugsNum);
+		visit(Column{ "Barges", ColumnType::INT32 }, record.config.bargesNum);
+		visit(Column{ "BTCs", ColumnType::INT32 }, record.config.BTCsNum);
+		visit(Column{ "RSDs", ColumnType::INT32 }, record.config.rsdNum);
+		visit(Column{ "Loading Rate (tonns/minute)", ColumnType::FLOAT32 }, record.config.intensity);
+		visit(Column{ "RSD Cargo (tonns)", ColumnType::FLOAT32 }, record.config.RSDcargo);
+		visit(Column{ "Barge/BTC Cargo (tonns)", ColumnType::FLOAT32 }, record.config.bargeCargo);
+		visit(Column{ "Dist Load->Drop (nm)", ColumnType::FLOAT32 }, record.config.distance);
+		visit(Column{ "Replications", ColumnType::INT32 }, record.replications);
+		visit(Column{ "Cut Off", ColumnType::INT32 }, record.cut);
+		visit(Column{ "Ammount (tonns)", ColumnType::FLOAT32 }, record.ammount);
+		forEachMeasure(record.stats, [&](const char* name, auto& field)
+		{
+			visit(Column{ name, std::is_integral<std::decay_t<decltype(field)>>::value ? ColumnType::INT32 : ColumnType::FLOAT32 }, field);
+		});
+	}
+
+	struct Filter
+	{
+		size_t column;
+		std::string operation;
+		double value;
+
+		bool passes(double x) const
+		{
+			if (operation == "=") return x == value;
+			if (operation == "!=") return x != value;
+			if (operation == "<") return x < value;
+			if (operation == "<=") return x <= value;
+			if (operation == ">") return x > value;
+			return x >= value;
+		}
+	};
+
+	Filter parseFilter(const ResultTable& table, const std::string& filter)
+	{
+		// The value is a number, so the last operator is the one: names like "Dist Load->Drop (nm)" have them too
+		size_t position = filter.find_last_of("!<>=");
+		size_t length = 1;
+		if (position != std::string::npos && position > 0 && filter[position] == '=' && std::strchr("!<>", filter[position - 1]))
+		{
+			--position;
+			length = 2;
+		}
+		if (position == std::string::npos || position == 0)
+			throw std::invalid_argument("Unable to parse filter \"" + filter + "\" - please use filters like \"Tugs=2\"");
+		const std::string operation = filter.substr(position, length);
+		if (operation == "!")
+			throw std::invalid_argument("Unable to parse filter \"" + filter + "\"");
+		const std::string value = filter.substr(position + length);
+		char* end = nullptr;
+		const double number = std::strtod(value.c_str(), &end);
+		if (value.empty() || *end)
+			throw std::invalid_argument("Unable to parse filter \"" + filter + "\" - the value must be a number");
+		return Filter{ table.column(filter.substr(0, position)), operation, number };
+	}
+
+	void writeValue(std::ostream& stream, const ResultTable& table, size_t column, size_t row)
+	{
+		if (table.columns()[column].type == ColumnType::INT32)
+			stream << static_cast<long long>(table.value(column, row));
+		else
+			stream << static_cast<float>(table.value(column, row));
+	}
+
+	void writeRow(std::ostream& stream, const ResultTable& table, size_t row)
+	{
+		for (size_t column = 0; column < table.columns().size(); ++column)
+		{
+			writeValue(stream, table, column, row);
+			stream << (column + 1 < table.columns().size() ? "\t" : "\n");
+		}
+	}
+
+	void writeHeader(std::ostream& stream, const ResultTable& table)
+	{
+		for (size_t column = 0; column < table.columns().size(); ++column)
+			stream << table.columns()[column].name << (column + 1 < table.columns().size() ? "\t" : "\n");
+	}
+}
+
+std::vector<Column> sweepColumns()
+{
+	std::vector<Column> columns;
+	SweepRecord record;
+	forEachColumn(record, [&](const Column& column, const auto&) { columns.push_back(column); });
+	return columns;
+}
+
+std::vector<double> sweepRow(const SweepRecord& record)
+{
+	std::vector<double> row;
+	forEachColumn(record, [&](const Column&, const auto& field) { row.push_back(static_cast<double>(field)); });
+	return row;
+}
+
+SweepRecord sweepRecord(const ResultTable& table, size_t row)
+{
+	SweepRecord record;
+	size_t column = 0;
+	forEachColumn(record, [&](const Column&, auto& field) { field = static_cast<std::decay_t<decltype(field)>>(table.value(column++, row)); });
+	record.stats.bargeCargo = record.config.bargeCargo;
+	record.stats.RSDcargo = record.config.RSDcargo;
+	record.stats.optimalDistLoadToDrop = record.config.distance;
+	return record;
+}
+
+void writeBestHeader(std::ostream& stream)
+{
+	stream
+		<< "Barge/BTC Cargo (tonns)\t"
+		<< "RSD Cargo (tonns)\t"
+		<< "Loading Rate (tonns/hour)\t"
+		<< "Barges\t"
+		<< "BTCs\t"
+		<< "RSDs\t"
+		<< "Tugs\t"
+		<< "Ammount (tonns)\t"
+		<< "Rides\t"
+		<< "Lost Waiting Tide (hours)\t"
+		<< "Lost Waiting Loadier (hours)\t"
+		<< "Lost Waiting Unloader (hours)\t"
+		<< "Lost Waiting OGV (hours)\t"
+		<< "Lost Waiting Tug (hours)\t"
+		<< "Spent By River Tugs On Moving (hours)\t"
+		<< "Spent By River Tugs On Waiting (hours)\t"
+		<< "Spent By Sea Tows On Moving (hours)\t"
+		<< "Spent By Sea Tows On Waiting (hours)\t"
+		<< "Optimal Dist Load->Drop (nm)\t"
+		<< "\n";
+}
+
+void writeBestRow(std::ostream& stream, const SweepRecord& record)
+{
+	const auto& stats = record.stats;
+	stream
+		<< stats.bargeCargo << "\t"
+		<< stats.RSDcargo << "\t"
+		<< record.config.intensity * 60 << "\t"
+		<< record.config.bargesNum << "\t"
+		<< record.config.BTCsNum << "\t"
+		<< record.config.rsdNum << "\t"
+		<< record.config.tugsNum << "\t"
+		<< record.ammount << "\t"
+		<< stats.passes << "\t"
+		<< stats.lostWaitingTide << "\t"
+		<< stats.lostWaitingLoader << "\t"
+		<< stats.lostWaitingUnloader << "\t"
+		<< stats.lostWaitingOGV << "\t"
+		<< stats.lostWaitingTug << "\t"
+		<< stats.spentByRiverTowsOnMoving << "\t"
+		<< stats.spentByRiverTowsOnWaiting << "\t"
+		<< stats.spentBySeaTowsOnMoving << "\t"
+		<< stats.spentBySeaTowsOnWaiting << "\t"
+		<< stats.optimalDistLoadToDrop << "\t"
+		<< "\n";
+}
+
+void analyze(const AnalysisOptions& options, std::ostream& out)
+{
+	const ResultTable table(options.path);
+	const auto expected = sweepColumns();
+	if (table.columns().size() != expected.size())
+		throw std::runtime_error(options.path + " has other columns than the sweep results");
+	for (size_t column = 0; column < expected.size(); ++column)
+		if (table.columns()[column].name != expected[column].name || table.columns()[column].type != expected[column].type)
+			throw std::runtime_error(options.path + " has other columns than the sweep results: " + table.columns()[column].name);
+
+	std::vector<Filter> filters;
+	for (const auto& filter : options.filters)
+		filters.push_back(parseFilter(table, filter));
+	std::vector<size_t> groupBy;
+	for (const auto& name : options.groupBy)
+		groupBy.push_back(table.column(name));
+	if (groupBy.empty())
+		groupBy.push_back(table.column("Group"));
+
+	const size_t point = table.column("Point");
+	const size_t cut = table.column("Cut Off");
+	const size_t ammount = table.column("Ammount (tonns)");
+
+	std::ofstream tsv;
+	if (!options.tsv.empty())
+	{
+		tsv.open(options.tsv);
+		if (!tsv.is_open())
+			throw std::runtime_error("Unable to write " + options.tsv);
+		writeHeader(tsv, table);
+	}
+
+	std::map<std::vector<double>, size_t> bests; // the best row by the values of groupBy
+	for (size_t row = 0; row < table.rows(); ++row)
+	{
+		if (!std::all_of(filters.begin(), filters.end(), [&](const Filter& filter) { return filter.passes(table.value(filter.column, row)); }))
+			continue;
+		if (tsv.is_open())
+			writeRow(tsv, table, row);
+		if (table.value(cut, row))
+			continue;
+
+		std::vector<double> key;
+		for (auto column : groupBy)
+			key.push_back(table.value(column, row));
+		const auto best = bests.find(key);
+		if (best == bests.end())
+			bests.emplace(key, row);
+		else if (table.value(ammount, row) > table.value(ammount, best->second)
+			|| (table.value(ammount, row) == table.value(ammount, best->second) && table.value(point, row) < table.value(point, best->second)))
+			best->second = row;
+	}
+
+	if (options.groupBy.empty())
+	{
+		writeBestHeader(out);
+		for (const auto& best : bests)
+			writeBestRow(out, sweepRecord(table, best.second));
+	}
+	else
+	{
+		writeHeader(out, table);
+		for (const auto& best : bests)
+			writeRow(out, table, best.second);
+	}
+}
@@ -0,0 +1,42 @@
+﻿#pragma once
+
+#include "results.h"
+#include "simulation.h"
+#include "sweep.h"
+
+#include <ostream>
+
+// An evaluated point of the sweep as it is kept in the result file
+struct SweepRecord
+{
+	size_t point = 0; // index of the point in the whole grid, the order of the exhaustive sweep
+	size_t group = 0;
+	SweepPoint config;
+	int replications = 0;
+	bool cut = false; // stopped by the cutoff: the amount and the stats are those of the moment it stopped
+	float ammount = 0.f;
+	SimulationStats stats;
+};
+
+// The parameters of the point, the amount and every measure of the stats
+std::vector<Column> sweepColumns();
+std::vector<double> sweepRow(const SweepRecord& record);
+// The table must have the columns of sweepColumns()
+SweepRecord sweepRecord(const ResultTable& table, size_t row);
+
+// The table of the best points, out.txt
+void writeBestHeader(std::ostream& stream);
+void writeBestRow(std::ostream& stream, const SweepRecord& record);
+
+struct AnalysisOptions
+{
+	std::string path;
+	std::vector<std::string> filters; // "column=value", also with !=, <, <=, >, >=
+	std::vector<std::string> groupBy; // columns; the groups of the sweep if empty
+	std::string tsv; // all the rows passing the filters are exported there if set
+};
+
+// Reproduces the table of the best points from a result file without simulating anything: the best
+// point of every sweep group as in out.txt, or the whole best rows of the groups of groupBy.
+// The best one is the complete run with the largest amount, the first one of the grid on ties
+void analyze(const AnalysisOptions& options, std::ostream& out);
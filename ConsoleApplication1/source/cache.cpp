@@ -0,0 +1,103 @@
+﻿#include "stdafx.h"
+
+#include "cache.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+
+namespace
+{
+	// The key is kept as two 32-bit halves
+	std::vector<Column> cacheColumns()
+	{
+		std::vector<Column> columns{ { "Key Low", ColumnType::INT32 }, { "Key High", ColumnType::INT32 }, { "Ammount (tonns)", ColumnType::FLOAT32 } };
+		const SimulationStats stats;
+		forEachMeasure(stats, [&](const char* name, const auto& field)
+		{
+			columns.push_back(Column{ name, std::is_integral<std::decay_t<decltype(field)>>::value ? ColumnType::INT32 : ColumnType::FLOAT32 });
+		});
+		return columns;
+	}
+
+	double keyHalf(std::uint64_t key, int shift)
+	{
+		return static_cast<std::int32_t>(static_cast<std::uint32_t>(key >> shift));
+	}
+
+	std::uint64_t joinKey(double low, double high)
+	{
+		return static_cast<std::uint64_t>(static_cast<std::uint32_t>(static_cast<std::int32_t>(high))) << 32
+			| static_cast<std::uint32_t>(static_cast<std::int32_t>(low));
+	}
+}
+
+std::uint64_t hashFile(const std::string& path)
+{
+	const MappedFile file(path);
+	return Fnv1a().add(file.data(), file.size()).value;
+}
+
+RunCache::RunCache(const std::string& path) : writer(path, cacheColumns(), 4096, load(path))
+{
+}
+
+bool RunCache::load(const std::string& path)
+{
+	std::error_code error;
+	if (!std::filesystem::file_size(path, error) || error)
+		return false;
+	// Any other file is left alone: the path may be a mistake
+	const ResultTable table(path);
+	const auto expected = cacheColumns();
+	if (table.columns().size() != expected.size() || !std::equal(expected.begin(), expected.end(), table.columns().begin(),
+		[](const Column& a, const Column& b) { return a.name == b.name && a.type == b.type; }))
+	{
+		if (table.columns().empty() || table.columns().front().name != expected.front().name)
+			throw std::runtime_error(path + " is not a cache of the runs");
+		std::cerr << path << " keeps other measures of the runs, it is started anew" << std::endl;
+		return false;
+	}
+
+	results.reserve(table.rows());
+	for (size_t row = 0; row < table.rows(); ++row)
+	{
+		Result result;
+		size_t column = 3;
+		result.first = static_cast<float>(table.value(2, row));
+		forEachMeasure(result.second, [&](const char*, auto& field) { field = static_cast<std::decay_t<decltype(field)>>(table.value(column++, row)); });
+		results.emplace(joinKey(table.value(0, row), table.value(1, row)), result);
+	}
+	return true;
+}
+
+size_t RunCache::size() const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex);
+	return results.size();
+}
+
+bool RunCache::find(std::uint64_t key, Result& result) const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex);
+	const auto found = results.find(key);
+	if (found == results.end())
+		return false;
+	result = found->second;
+	return true;
+}
+
+void RunCache::store(std::uint64_t key, const Result& result)
+{
+	{
+		std::unique_lock<std::shared_mutex> lock(mutex);
+		if (!results.emplace(key, result).second)
+			return;
+	}
+	std::vector<double> row{ keyHalf(key, 0), keyHalf(key, 32), result.first };
+	forEachMeasure(result.second, [&](const char*, double value) { row.push_back(value); });
+	writer.append(row);
+}
@@ -0,0 +1,42 @@
+﻿#pragma once
+
+#include "results.h"
+#include "simulation.h"
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// FNV-1a of the content of the file; throws if the file can't be read
+std::uint64_t hashFile(const std::string& path);
+
+// Results of the runs kept on disk from one sweep to the next. A run is found by its key: a hash of everything
+// it depends on - the model version, the content of the input files and the run as it is set up
+// (Simulation::hashInto, the standard library too if it draws the OGVs). A result of other inputs has another
+// key and is never found, so nothing is invalidated.
+// The file is a result file of the key, the amount and the measures of every run; new runs are appended to it
+// and a cache of other measures is started anew
+struct RunCache
+{
+	using Result = std::pair<float, SimulationStats>;
+
+	explicit RunCache(const std::string& path);
+
+	size_t size() const;
+	// The amount and the measures of the run, optimalDistLoadToDrop, bargeCargo and RSDcargo are not kept;
+	// false if the run has never been stored
+	bool find(std::uint64_t key, Result& result) const;
+	// May be called from any thread
+	void store(std::uint64_t key, const Result& result);
+	void flush() { writer.flush(); }
+
+private:
+	// Reads the runs of the file; false if there are none to append to. Throws if it is not a cache
+	bool load(const std::string& path);
+
+	std::unordered_map<std::uint64_t, Result> results;
+	mutable std::shared_mutex mutex;
+	ResultWriter writer;
+};
@@ -0,0 +1,36 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// FNV-1a of 64 bits over the fields added to it one after another; the cached runs are found by such hashes
+struct Fnv1a
+{
+	std::uint64_t value = 14695981039346656037ull;
+
+	Fnv1a& add(const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; ++i)
+			value = (value ^ bytes[i]) * 1099511628211ull;
+		return *this;
+	}
+
+	// Numbers and enums by their bytes
+	template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value || std::is_enum<T>::value>>
+	Fnv1a& operator<<(T field) { return add(&field, sizeof(field)); }
+	// The length goes first: "ab", "c" and "a", "bc" differ
+	Fnv1a& operator<<(const char* text)
+	{
+		const size_t length = std::strlen(text);
+		*this << length;
+		return add(text, length);
+	}
+	Fnv1a& operator<<(const std::string& text)
+	{
+		*this << text.size();
+		return add(text.data(), text.size());
+	}
+};
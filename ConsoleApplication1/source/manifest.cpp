@@ -0,0 +1,189 @@
+﻿#include "stdafx.h"
+
+#include "manifest.h"
+#include "core.h"
+
+#include <set>
+
+namespace
+{
+	// The next word of the line after the blanks, dropped from the line; empty at the end of the line
+	std::string_view nextWord(std::string_view& line)
+	{
+		const size_t first = line.find_first_not_of(" \t");
+		if (first == std::string_view::npos)
+		{
+			line = std::string_view();
+			return line;
+		}
+		const size_t last = std::min(line.find_first_of(" \t", first), line.size());
+		const std::string_view word = line.substr(first, last - first);
+		line.remove_prefix(last);
+		return word;
+	}
+
+	bool blank(std::string_view line)
+	{
+		return line.find_first_not_of(" \t") == std::string_view::npos;
+	}
+
+	// All the numbers of the rest of the line, empty if there is something else there
+	template <typename T>
+	std::vector<T> parseNumbers(std::string_view line)
+	{
+		std::vector<T> numbers;
+		for (T number; parseNumber(line, number); )
+			numbers.push_back(number);
+		if (!blank(line))
+			numbers.clear();
+		return numbers;
+	}
+}
+
+std::vector<float> ValueRange::values() const
+{
+	if (step <= 0.f)
+		return { from };
+	std::vector<float> values;
+	for (float value = from; value <= to + step * 1e-3f; value += step) // the steps add up rounding errors
+		values.push_back(value);
+	return values;
+}
+
+SweepGrid Scenario::grid() const
+{
+	LoadingOrder first;
+	if (orders && !orders->get(0, first))
+		throw std::runtime_error("Scenario " + name + " has no orders");
+	const auto cargos = [&](const ValueRange &range) { return orders ? std::vector<float>{ first.loadCargo } : range.values(); };
+	const std::vector<float> RSDcargos = cargos(RSDcargo);
+	const std::vector<float> bargeCargos = cargos(bargeCargo);
+	const std::vector<float> BTCcargos = cargos(BTCcargo);
+	const std::vector<float> distances = distance.values();
+	const std::vector<float> rates = orders ? std::vector<float>{ first.loadIntensity } : intensities;
+
+	SweepGrid grid;
+	for (int tugsNum : tugs)
+		for (const auto &fleet : fleets)
+		{
+			if (fleet.first && fleet.second)
+				throw std::runtime_error("Please select BTC or barge");
+			for (int rsdNum : rsds)
+				for (float intensity : rates)
+				{
+					SweepGroup group;
+					group.config.tugsNum = tugsNum;
+					group.config.bargesNum = fleet.first;
+					group.config.BTCsNum = fleet.second;
+					group.config.rsdNum = rsdNum;
+					group.config.intensity = intensity;
+					group.RSDcargos = RSDcargos;
+					group.bargeCargos = fleet.first ? bargeCargos : BTCcargos;
+					group.distances = distances;
+					grid.add(std::move(group));
+				}
+		}
+	return grid;
+}
+
+std::string Scenario::output(const std::string& path) const
+{
+	if (name.empty())
+		return path;
+	const size_t fileName = path.find_last_of("/\\") + 1;
+	return path.substr(0, fileName) + name + "_" + path.substr(fileName);
+}
+
+std::vector<Scenario> readManifest(const std::string& path)
+{
+	TextLines lines(path);
+	std::vector<Scenario> scenarios;
+	std::set<std::string> names;
+	bool fleetsSet = false; // the first fleet line of a scenario replaces the built-in fleets
+	size_t number = 0;
+	for (std::string_view line; lines.next(line); )
+	{
+		++number;
+		const auto fail = [&](const std::string& reason)
+		{
+			throw std::runtime_error(path + ":" + std::to_string(number) + ": " + reason);
+		};
+		line = line.substr(0, line.find('#'));
+		const std::string key(nextWord(line));
+		if (key.empty())
+			continue;
+
+		if (key == "scenario")
+		{
+			const std::string name(nextWord(line));
+			if (name.empty() || !blank(line) || name.find_first_of("/\\:") != std::string::npos)
+				fail("a scenario needs a name of a single word, it is a prefix of the file names");
+			if (!names.insert(name).second)
+				fail("scenario " + name + " is already there");
+			scenarios.emplace_back();
+			scenarios.back().name = name;
+			fleetsSet = false;
+			continue;
+		}
+		if (scenarios.empty())
+			fail(key + " before the first scenario");
+		Scenario &scenario = scenarios.back();
+
+		if (key == "tugs" || key == "rsds")
+		{
+			const auto counts = parseNumbers<int>(line);
+			if (counts.empty() || std::any_of(counts.begin(), counts.end(), [&](int count) { return count < (key == "tugs" ? 1 : 0); }))
+				fail(key + " needs counts of vessels");
+			(key == "tugs" ? scenario.tugs : scenario.rsds) = counts;
+		}
+		else if (key == "fleet")
+		{
+			const auto fleet = parseNumbers<int>(line);
+			if (fleet.size() != 2 || fleet[0] < 0 || fleet[1] < 0 || (fleet[0] && fleet[1]))
+				fail("fleet needs the barges and the BTCs, one of them 0");
+			if (!fleetsSet)
+				scenario.fleets.clear();
+			fleetsSet = true;
+			scenario.fleets.emplace_back(fleet[0], fleet[1]);
+		}
+		else if (key == "intensity")
+		{
+			const auto rates = parseNumbers<float>(line);
+			if (rates.empty() || std::any_of(rates.begin(), rates.end(), [](float rate) { return rate <= 0.f; }))
+				fail("intensity needs loading rates in tonns per hour");
+			scenario.intensities.clear();
+			for (float rate : rates)
+				scenario.intensities.push_back(rate / 60.f);
+		}
+		else if (key == "rsd-cargo" || key == "barge-cargo" || key == "btc-cargo" || key == "distance")
+		{
+			const auto range = parseNumbers<float>(line);
+			if ((range.size() != 1 && range.size() != 3) || (range.size() == 3 && (range[2] <= 0.f || range[1] < range[0])))
+				fail(key + " needs a value or FROM TO STEP");
+			ValueRange &values = key == "rsd-cargo" ? scenario.RSDcargo
+				: key == "barge-cargo" ? scenario.bargeCargo
+				: key == "btc-cargo" ? scenario.BTCcargo
+				: scenario.distance;
+			values = range.size() == 1 ? ValueRange{ range[0], range[0], 0.f } : ValueRange{ range[0], range[1], range[2] };
+		}
+		else if (key == "orders")
+		{
+			const std::string file(nextWord(line));
+			const std::string mode(nextWord(line));
+			if (file.empty() || !(mode.empty() || mode == "repeat") || !blank(line))
+				fail("orders needs a file and may repeat");
+			const auto schedule = std::make_shared<ScheduledOrders>();
+			if (!schedule->readFromFile(file) || !schedule->size())
+				fail("no orders in " + file);
+			if (mode == "repeat")
+				scenario.orders = std::make_shared<CyclicOrders>(schedule->all());
+			else
+				scenario.orders = schedule;
+		}
+		else
+			fail("unknown setting " + key + " (expected: scenario, tugs, fleet, rsds, intensity, rsd-cargo, barge-cargo, btc-cargo, distance, orders)");
+	}
+	if (scenarios.empty())
+		throw std::runtime_error(path + " has no scenarios");
+	return scenarios;
+}
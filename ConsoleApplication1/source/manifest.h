@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include "orders.h"
+#include "sweep.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Values from, from + step ... up to to
+struct ValueRange
+{
+	float from = 0.f;
+	float to = 0.f;
+	float step = 1.f;
+
+	std::vector<float> values() const;
+};
+
+// A study: the parameter spaces its sweep goes through. Every (tugs, fleet, RSDs, intensity) is a group
+// of the sweep, the grid of the RSD cargo x the barge or BTC cargo x the distance
+struct Scenario
+{
+	std::string name; // the prefix of the output files, none for the built-in study
+	std::vector<int> tugs{ 1, 2 };
+	std::vector<std::pair<int, int>> fleets{ { 2, 0 }, { 3, 0 }, { 4, 0 }, { 0, 1 }, { 0, 2 }, { 0, 2 } }; // barges, BTCs
+	std::vector<int> rsds{ 0 };
+	std::vector<float> intensities{ 1500 / 60.f, 2000 / 60.f }; // tonns per minute
+	ValueRange RSDcargo{ 3000.f, 7200.f, 200.f };
+	ValueRange bargeCargo{ 3000.f, 6000.f, 200.f };
+	ValueRange BTCcargo{ 3000.f, 12000.f, 200.f };
+	ValueRange distance{ 4.f, 15.f, 1.f };
+	// The orders of all the vessels instead of their cargo at the loading rate of the point; the grid then has
+	// a single cargo and loading rate, the ones of the first order. None for the built-in study
+	OrderSource::ConstPtr orders;
+
+	SweepGrid grid() const;
+	// The path of an output file of the scenario: the name goes before the file name
+	std::string output(const std::string& path) const;
+};
+
+// Reads the scenarios of a manifest, throws on the first line it can't parse. A manifest is lines like
+//   scenario NAME                  starts a scenario, the rest of the lines set it up
+//   tugs 1 2
+//   fleet BARGES BTCS              a line per fleet
+//   rsds 0 1
+//   intensity 1500 2000            tonns per hour
+//   rsd-cargo FROM TO STEP         tonns, or a single value
+//   barge-cargo FROM TO STEP
+//   btc-cargo FROM TO STEP
+//   distance FROM TO STEP          nautical miles
+//   orders FILE [repeat]           the vessels take the orders of the file one after another, lines of
+//                                  "[cargo, tonns] [loading rate, tonns/hour]"; after the last one they take
+//                                  the default order or, with repeat, start over
+// The settings a scenario doesn't have are the ones of the built-in study; # starts a comment
+std::vector<Scenario> readManifest(const std::string& path);
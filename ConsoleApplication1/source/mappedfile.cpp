@@ -0,0 +1,88 @@
+﻿#include "stdafx.h"
+
+#include "mappedfile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path)
+{
+	fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		fileHandle = nullptr;
+		throw std::runtime_error("Unable to open " + path);
+	}
+	LARGE_INTEGER fileSize;
+	GetFileSizeEx(fileHandle, &fileSize);
+	length = static_cast<size_t>(fileSize.QuadPart);
+	if (!length)
+		return;
+	mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping)
+		begin = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!begin)
+	{
+		release();
+		throw std::runtime_error("Unable to map " + path);
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	release();
+}
+
+void MappedFile::release()
+{
+	if (begin)
+		UnmapViewOfFile(begin);
+	if (mapping)
+		CloseHandle(mapping);
+	if (fileHandle)
+		CloseHandle(fileHandle);
+	begin = nullptr;
+	mapping = fileHandle = nullptr;
+}
+#else
+MappedFile::MappedFile(const std::string& path)
+{
+	const int descriptor = open(path.c_str(), O_RDONLY);
+	if (descriptor < 0)
+		throw std::runtime_error("Unable to open " + path);
+	struct stat status;
+	if (fstat(descriptor, &status) == 0)
+		length = static_cast<size_t>(status.st_size);
+	if (length)
+	{
+		void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (address != MAP_FAILED)
+			begin = static_cast<const char*>(address);
+	}
+	close(descriptor);
+	if (length && !begin)
+		throw std::runtime_error("Unable to map " + path);
+}
+
+MappedFile::~MappedFile()
+{
+	release();
+}
+
+void MappedFile::release()
+{
+	if (begin)
+		munmap(const_cast<char*>(begin), length);
+	begin = nullptr;
+}
+#endif
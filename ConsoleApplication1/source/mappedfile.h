@@ -0,0 +1,26 @@
+﻿#pragma once
+
+#include <string>
+
+// Read-only view of a file mapped into memory
+struct MappedFile
+{
+	explicit MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const char* data() const { return begin; }
+	size_t size() const { return length; }
+
+private:
+	void release();
+
+	const char* begin = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mapping = nullptr;
+#endif
+};
@@ -0,0 +1,188 @@
+﻿#pragma once
+
+#include <vector>
+#include <map>
+#include <set>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+
+// Search of the best point of a grid without evaluating all of it: coordinate descent with
+// golden-section search over the axes that are roughly unimodal and coarse-to-fine refinement over
+// the others. The simulation counts integer minutes, so the score has plateaus and steps: every line
+// search keeps several candidates and polishes the neighbourhood of the winner.
+// Equal scores go to the point that comes first in the row-major order of the grid, the way the
+// exhaustive sweep picks it. Every point is evaluated at most once.
+template <typename Result>
+struct GridOptimizer
+{
+	using Point = std::vector<size_t>; // index along every axis
+
+	enum class Search { GOLDEN_SECTION, COARSE_TO_FINE };
+	struct Axis
+	{
+		size_t size;
+		Search search;
+	};
+
+	GridOptimizer(std::vector<Axis> axes, std::function<Result(const Point&)> evaluate, std::function<float(const Result&)> score)
+		: axes(std::move(axes)), evaluate(std::move(evaluate)), score(std::move(score))
+	{
+		for (const auto &axis : this->axes)
+			if (!axis.size)
+				throw std::invalid_argument("Empty axis of the grid");
+	}
+
+	// Returns the best result found; the point of it is bestPoint().
+	// The descent is started from both ends and the middle of the golden-section axes, so a ridge
+	// across two axes does not stop it at the first local top
+	const Result &optimize(size_t maxRounds = 8)
+	{
+		for (size_t start = 0; start < 3; ++start)
+		{
+			Point point(axes.size());
+			for (size_t axis = 0; axis < axes.size(); ++axis)
+				if (axes[axis].search == Search::GOLDEN_SECTION)
+					point[axis] = (axes[axis].size - 1) * start / 2;
+			descend(point, maxRounds);
+		}
+		return best->second;
+	}
+
+	const Point &bestPoint() const { return best->first; }
+	size_t evaluations() const { return cache.size(); }
+
+private:
+	using Cache = std::map<Point, Result>;
+
+	void descend(Point point, size_t maxRounds)
+	{
+		for (size_t round = 0; round < maxRounds; ++round)
+		{
+			const Point before = point;
+			for (size_t axis = 0; axis < axes.size(); ++axis)
+				point[axis] = axes[axis].search == Search::GOLDEN_SECTION ? goldenSection(point, axis) : coarseToFine(point, axis);
+			if (point == before)
+				break;
+		}
+	}
+
+	// Row-major position of the point, the order of the exhaustive sweep
+	size_t order(const Point &point) const
+	{
+		size_t index = 0;
+		for (size_t axis = 0; axis < axes.size(); ++axis)
+			index = index * axes[axis].size + point[axis];
+		return index;
+	}
+
+	bool better(const typename Cache::value_type &lhs, const typename Cache::value_type &rhs) const
+	{
+		const float lhsScore = score(lhs.second);
+		const float rhsScore = score(rhs.second);
+		return lhsScore > rhsScore || (lhsScore == rhsScore && order(lhs.first) < order(rhs.first));
+	}
+
+	const typename Cache::value_type &consider(const Point &point)
+	{
+		auto known = cache.find(point);
+		if (known == cache.end())
+		{
+			known = cache.emplace(point, evaluate(point)).first;
+			if (best == cache.end() || better(*known, *best))
+				best = known;
+		}
+		return *known;
+	}
+
+	const typename Cache::value_type &along(Point point, size_t axis, size_t index)
+	{
+		point[axis] = index;
+		return consider(point);
+	}
+
+	// Best index of the line through the point along the axis among the candidates
+	size_t bestOf(const Point &point, size_t axis, const std::set<size_t> &candidates)
+	{
+		const typename Cache::value_type *winner = nullptr;
+		for (auto index : candidates)
+		{
+			const auto &result = along(point, axis, index);
+			if (!winner || better(result, *winner))
+				winner = &result;
+		}
+		return winner->first[axis];
+	}
+
+	size_t polish(const Point &point, size_t axis, size_t center, size_t radius)
+	{
+		std::set<size_t> candidates;
+		for (size_t index = center > radius ? center - radius : 0; index <= std::min(center + radius, axes[axis].size - 1); ++index)
+			candidates.insert(index);
+		return bestOf(point, axis, candidates);
+	}
+
+	size_t goldenSection(const Point &point, size_t axis)
+	{
+		const float ratio = 0.618034f;
+		size_t low = 0, high = axes[axis].size - 1;
+		while (high - low > 2)
+		{
+			const size_t left = high - static_cast<size_t>((high - low) * ratio);
+			const size_t right = low + static_cast<size_t>((high - low) * ratio);
+			if (left >= right)
+				break;
+			if (better(along(point, axis, right), along(point, axis, left)))
+				low = left;
+			else
+				high = right;
+		}
+		// the plateaus may hide the top, so the ends and a few steps around the bracket are checked too
+		std::set<size_t> candidates{ 0, axes[axis].size - 1 };
+		for (size_t index = low; index <= high; ++index)
+			candidates.insert(index);
+		const size_t winner = bestOf(point, axis, candidates);
+		return polish(point, axis, winner, 2);
+	}
+
+	size_t coarseToFine(const Point &point, size_t axis)
+	{
+		const size_t size = axes[axis].size;
+		const size_t keep = 3; // candidates refined on every level
+		size_t stride = std::max<size_t>(1, size / 8);
+
+		std::set<size_t> level{ size - 1 };
+		for (size_t index = 0; index < size; index += stride)
+			level.insert(index);
+		while (true)
+		{
+			std::vector<const typename Cache::value_type *> ranked;
+			for (auto index : level)
+				ranked.push_back(&along(point, axis, index));
+			std::sort(ranked.begin(), ranked.end(), [this](const typename Cache::value_type *lhs, const typename Cache::value_type *rhs) { return better(*lhs, *rhs); });
+			ranked.resize(std::min(keep, ranked.size()));
+			if (stride == 1)
+			{
+				return polish(point, axis, ranked.front()->first[axis], 1);
+			}
+			stride = (stride + 1) / 2;
+			level.clear();
+			for (auto candidate : ranked)
+			{
+				const size_t center = candidate->first[axis];
+				level.insert(center);
+				if (center >= stride)
+					level.insert(center - stride);
+				if (center + stride < size)
+					level.insert(center + stride);
+			}
+		}
+	}
+
+	std::vector<Axis> axes;
+	std::function<Result(const Point&)> evaluate;
+	std::function<float(const Result&)> score;
+
+	Cache cache;
+	typename Cache::const_iterator best = cache.end();
+};
@@ -0,0 +1,121 @@
+﻿#pragma once
+
+#include "core.h"
+
+#include <limits>
+
+struct LoadingOrder
+{
+	LoadingOrder(float cargo = 5000, float intensity = 2000 / 60) : loadCargo(cargo), loadIntensity(intensity) {}
+	float loadCargo;
+	float loadIntensity; // tonns per minute
+};
+
+// Where the loading orders of vessels come from. Orders are produced on demand and a source may be
+// shared by many vessels: every vessel counts the orders it has taken itself
+struct OrderSource
+{
+	using Ptr = std::shared_ptr<OrderSource>;
+	using ConstPtr = std::shared_ptr<const OrderSource>;
+
+	static constexpr size_t unlimited = std::numeric_limits<size_t>::max();
+
+	virtual ~OrderSource() = default;
+
+	// Order number index of a vessel; false if the schedule has ended before it
+	virtual bool get(size_t index, LoadingOrder &order) const = 0;
+	// Adds the kind of the source and all its orders to the key of a run
+	virtual void hashInto(Fnv1a &key) const = 0;
+};
+
+// The same order over and over again
+struct ConstantOrders : OrderSource
+{
+	explicit ConstantOrders(const LoadingOrder &order, size_t count = unlimited) : order(order), count(count) {}
+
+	bool get(size_t index, LoadingOrder &result) const override
+	{
+		if (index >= count)
+			return false;
+		result = order;
+		return true;
+	}
+	void hashInto(Fnv1a &key) const override { key << "constant" << order.loadCargo << order.loadIntensity << count; }
+
+private:
+	LoadingOrder order;
+	size_t count;
+};
+
+// A pattern of orders repeated endlessly
+struct CyclicOrders : OrderSource
+{
+	explicit CyclicOrders(std::vector<LoadingOrder> pattern) : pattern(std::move(pattern))
+	{
+		if (this->pattern.empty())
+			throw std::invalid_argument("Empty pattern of orders");
+	}
+
+	bool get(size_t index, LoadingOrder &order) const override
+	{
+		order = pattern[index % pattern.size()];
+		return true;
+	}
+	void hashInto(Fnv1a &key) const override
+	{
+		key << "cyclic" << pattern.size();
+		for (const auto &order : pattern)
+			key << order.loadCargo << order.loadIntensity;
+	}
+
+private:
+	std::vector<LoadingOrder> pattern;
+};
+
+// A finite schedule read from a file
+struct ScheduledOrders : OrderSource
+{
+	bool get(size_t index, LoadingOrder &order) const override
+	{
+		if (index >= orders.size())
+			return false;
+		order = orders[index];
+		return true;
+	}
+	void hashInto(Fnv1a &key) const override
+	{
+		key << "scheduled" << orders.size();
+		for (const auto &order : orders)
+			key << order.loadCargo << order.loadIntensity;
+	}
+
+	void add(const LoadingOrder &order) { orders.push_back(order); }
+
+	// Every line is "[cargo, tonns] [loading rate, tonns/hour]"
+	bool readFromFile(const std::string& path)
+	{
+		std::ifstream infile(path);
+		std::string line;
+		if (!infile.is_open())
+		{
+			std::cerr << "Unabe to read file " << path << " - make sure the file exists" << std::endl;
+			return false;
+		}
+		while (std::getline(infile, line))
+		{
+			std::istringstream iss(line);
+			float cargo, rate;
+			if (iss >> cargo >> rate)
+				add(LoadingOrder(cargo, rate / 60));
+			else if (line.size())
+				std::cerr << "Unable to parse string: \"" << line << "\" - please use strings like \"[cargo] [loading rate]\"" << std::endl;
+		}
+		return true;
+	}
+
+	size_t size() const { return orders.size(); }
+	const std::vector<LoadingOrder> &all() const { return orders; }
+
+private:
+	std::vector<LoadingOrder> orders;
+};
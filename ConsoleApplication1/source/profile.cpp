@@ -0,0 +1,69 @@
+﻿#include "stdafx.h"
+
+#include "profile.h"
+
+#include <iomanip>
+#include <thread>
+
+namespace
+{
+	const char* const phaseNames[] = { "run", "getNextShip", "load", "goUnloading", "goLoading", "unload", "passRief", "ogvWaitingTime", "summonTow" };
+	static_assert(sizeof(phaseNames) / sizeof(phaseNames[0]) == static_cast<size_t>(Phase::COUNT), "A name for every phase");
+
+	double milliseconds(std::uint64_t ticks)
+	{
+		return ticks * TickClock::nanosecondsPerTick() / 1e6;
+	}
+}
+
+double TickClock::nanosecondsPerTick()
+{
+#if defined(_M_X64) || defined(__x86_64__)
+	static const double ratio = []
+	{
+		const auto start = std::chrono::steady_clock::now();
+		const std::uint64_t startTicks = now();
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		const auto end = std::chrono::steady_clock::now();
+		const std::uint64_t endTicks = now();
+		return std::chrono::duration<double, std::nano>(end - start).count() / (endTicks - startTicks);
+	}();
+	return ratio;
+#else
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::duration(1)).count();
+#endif
+}
+
+void Profile::merge(const Profile& other)
+{
+	for (size_t phase = 0; phase < counters.size(); ++phase)
+	{
+		counters[phase].calls += other.counters[phase].calls;
+		counters[phase].total += other.counters[phase].total;
+		counters[phase].self += other.counters[phase].self;
+		counters[phase].events += other.counters[phase].events;
+	}
+}
+
+void Profile::print(std::ostream& stream) const
+{
+	const double runTime = milliseconds((*this)[Phase::RUN].total);
+	stream << "\nProfile of " << runs() << " run(s):\n"
+		<< "Phase\tCalls\tTotal (ms)\tSelf (ms)\tSelf (%)\tPer Call (ns)\tEvents\n";
+	const auto flags = stream.flags();
+	const auto precision = stream.precision();
+	stream << std::fixed;
+	for (size_t phase = 0; phase < counters.size(); ++phase)
+	{
+		const Counters& phaseCounters = counters[phase];
+		stream << phaseNames[phase] << "\t"
+			<< phaseCounters.calls << "\t"
+			<< std::setprecision(3) << milliseconds(phaseCounters.total) << "\t"
+			<< milliseconds(phaseCounters.self) << "\t"
+			<< std::setprecision(1) << (runTime > 0 ? 100 * milliseconds(phaseCounters.self) / runTime : 0.) << "\t"
+			<< (phaseCounters.calls ? 1e6 * milliseconds(phaseCounters.total) / phaseCounters.calls : 0.) << "\t"
+			<< phaseCounters.events << "\n";
+	}
+	stream.flags(flags);
+	stream.precision(precision);
+}
@@ -0,0 +1,120 @@
+﻿#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+#if defined(_M_X64)
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+// Where the wall time of the runs goes. Every timed phase counts its calls, its time with the phases it calls
+// (total) and without them (self), and the vessel events recorded meanwhile. The timers are compiled in unless
+// SIMULATION_NO_PROFILING is defined; a run is timed only if its Simulation has profiling set
+enum class Phase : unsigned char
+{
+	RUN, GET_NEXT_SHIP, LOAD, GO_UNLOADING, GO_LOADING, UNLOAD, PASS_RIEF, OGV_WAITING_TIME, SUMMON_TOW,
+	COUNT
+};
+
+// Events recorded by the vessels of the thread, ShipBase::account counts them when profiling is compiled in
+inline thread_local std::uint64_t recordedEvents = 0;
+
+// The cheapest monotonic clock at hand: the time stamp counter on x86-64, steady_clock elsewhere.
+// The ticks are turned into time only when a profile is printed
+struct TickClock
+{
+	static std::uint64_t now()
+	{
+#if defined(_M_X64) || defined(__x86_64__)
+		return __rdtsc();
+#else
+		return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+	}
+	// Measured against steady_clock once per process
+	static double nanosecondsPerTick();
+};
+
+struct PhaseTimer;
+
+struct Profile
+{
+	struct Counters
+	{
+		std::uint64_t calls = 0;
+		std::uint64_t total = 0; // ticks of TickClock
+		std::uint64_t self = 0;
+		std::uint64_t events = 0;
+	};
+
+	const Counters& operator[](Phase phase) const { return counters[static_cast<size_t>(phase)]; }
+	std::uint64_t runs() const { return counters[static_cast<size_t>(Phase::RUN)].calls; }
+
+	void clear() { *this = Profile(); }
+	// Adds the counters of the other profile, the profiles of the workers of a sweep are merged so
+	void merge(const Profile& other);
+
+	// A line per phase: the calls, the total and the self time, the share of the self time in the runs,
+	// the time per call and the events
+	void print(std::ostream& stream) const;
+
+private:
+	friend struct PhaseTimer;
+
+	std::array<Counters, static_cast<size_t>(Phase::COUNT)> counters{};
+	PhaseTimer *active = nullptr; // the innermost phase being timed
+};
+
+#ifndef SIMULATION_NO_PROFILING
+
+// Times the phase from the construction to the end of the scope, if there is a profile
+struct PhaseTimer
+{
+	PhaseTimer(Profile* profile, Phase phase) : profile(profile), phase(phase)
+	{
+		if (!profile)
+			return;
+		parent = profile->active;
+		profile->active = this;
+		events = recordedEvents;
+		start = TickClock::now();
+	}
+	~PhaseTimer()
+	{
+		if (!profile)
+			return;
+		const std::uint64_t elapsed = TickClock::now() - start;
+		auto& counters = profile->counters[static_cast<size_t>(phase)];
+		++counters.calls;
+		counters.total += elapsed;
+		counters.self += elapsed - children;
+		counters.events += recordedEvents - events;
+		if (parent)
+			parent->children += elapsed;
+		profile->active = parent;
+	}
+
+	PhaseTimer(const PhaseTimer&) = delete;
+	PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+	Profile* profile;
+	Phase phase;
+	PhaseTimer* parent = nullptr;
+	std::uint64_t start = 0;
+	std::uint64_t children = 0;
+	std::uint64_t events = 0;
+};
+
+#else
+
+struct PhaseTimer
+{
+	PhaseTimer(Profile*, Phase) {}
+};
+
+#endif
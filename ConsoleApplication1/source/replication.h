@@ -0,0 +1,159 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <limits>
+
+#include "hash.h"
+
+// Counter-based generator Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+// The n-th number of a stream is a function of the seed, the stream and n only: a replication draws
+// the same numbers whatever thread runs it and whatever ran on that thread before
+struct Philox4x32
+{
+	using result_type = std::uint32_t;
+
+	// An antithetic stream mirrors the draws of the plain one: 1 - u for uniforms, the reflected normals
+	explicit Philox4x32(std::uint64_t seed = 0, std::uint64_t stream = 0, bool antithetic = false)
+		: key{ { low(seed), high(seed) } }, counter{ { 0, 0, low(stream), high(stream) } }, antithetic(antithetic)
+	{
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	result_type operator()()
+	{
+		if (used == block.size())
+		{
+			block = generate(counter, key);
+			if (!++counter[0])
+				++counter[1];
+			used = 0;
+		}
+		return block[used++];
+	}
+
+	// Uniform on (0, 1), symmetric around 1/2
+	double uniform()
+	{
+		const double u = (static_cast<double>((*this)()) + .5) / 4294967296.;
+		return antithetic ? 1. - u : u;
+	}
+
+	// Box-Muller transform; the second value of a pair is kept for the next call
+	double normal(double mean, double stddev)
+	{
+		double z;
+		if (hasSpare)
+		{
+			hasSpare = false;
+			z = spare;
+		}
+		else
+		{
+			const double radius = std::sqrt(-2. * std::log((static_cast<double>((*this)()) + .5) / 4294967296.));
+			const double angle = 2. * 3.14159265358979323846 * (static_cast<double>((*this)()) + .5) / 4294967296.;
+			spare = radius * std::sin(angle);
+			hasSpare = true;
+			z = radius * std::cos(angle);
+		}
+		return mean + stddev * (antithetic ? -z : z);
+	}
+
+	using Block = std::array<result_type, 4>;
+	using Key = std::array<result_type, 2>;
+
+	static Block generate(Block counter, Key key)
+	{
+		for (int round = 0; round < 10; ++round)
+		{
+			const std::uint64_t product0 = static_cast<std::uint64_t>(0xD2511F53u) * counter[0];
+			const std::uint64_t product1 = static_cast<std::uint64_t>(0xCD9E8D57u) * counter[2];
+			counter = { { high(product1) ^ counter[1] ^ key[0], low(product1), high(product0) ^ counter[3] ^ key[1], low(product0) } };
+			key[0] += 0x9E3779B9u;
+			key[1] += 0xBB67AE85u;
+		}
+		return counter;
+	}
+
+private:
+	static result_type low(std::uint64_t value) { return static_cast<result_type>(value); }
+	static result_type high(std::uint64_t value) { return static_cast<result_type>(value >> 32); }
+
+	Key key;
+	Block counter;
+	Block block{};
+	size_t used = 4;
+
+	bool antithetic;
+	double spare = 0.;
+	bool hasSpare = false;
+};
+
+// Random inputs of a replication as named streams. A stream depends on the seed, the replication and
+// its name only, so every configuration run in a replication sees the same OGV arrivals, the same
+// tide phase and so on (common random numbers), and a new random input does not shift the old ones.
+// With antithetic pairs the odd replication mirrors the even one before it
+struct RandomStreams
+{
+	RandomStreams(std::uint64_t seed = 0, std::uint64_t replication = 0, bool antithetic = false)
+		: seed(seed), replication(antithetic ? replication / 2 : replication), antithetic(antithetic && replication % 2)
+	{
+	}
+
+	Philox4x32 operator()(const char *name) const
+	{
+		return Philox4x32(seed, static_cast<std::uint64_t>(hash(name)) << 32 | (replication & 0xFFFFFFFFu), antithetic);
+	}
+
+	void hashInto(Fnv1a &key) const { key << seed << replication << antithetic; }
+
+private:
+	// FNV-1a
+	static std::uint32_t hash(const char *name)
+	{
+		std::uint32_t value = 2166136261u;
+		for (; *name; ++name)
+			value = (value ^ static_cast<unsigned char>(*name)) * 16777619u;
+		return value;
+	}
+
+	std::uint64_t seed;
+	std::uint64_t replication;
+	bool antithetic;
+};
+
+// Mean, variance and confidence interval of a measure over the replications (Welford's update)
+struct Estimate
+{
+	void add(double value)
+	{
+		++count;
+		const double delta = value - mean;
+		mean += delta / count;
+		squares += delta * (value - mean);
+	}
+
+	double variance() const { return count > 1 ? squares / (count - 1) : 0.; }
+
+	// Half width of the 95% confidence interval of the mean, Student's t for small samples
+	double halfWidth() const
+	{
+		static const double t975[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+			2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+			2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+		if (count < 2)
+			return 0.;
+		const size_t freedom = count - 1;
+		const double t = freedom <= 30 ? t975[freedom - 1] : 1.960;
+		return t * std::sqrt(variance() / count);
+	}
+
+	size_t count = 0;
+	double mean = 0.;
+
+private:
+	double squares = 0.;
+};
@@ -0,0 +1,186 @@
+﻿#include "stdafx.h"
+
+#include "results.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <iostream>
+
+namespace
+{
+	const char magic[8] = { 'S', 'W', 'E', 'E', 'P', 'R', 'E', 'S' };
+	const std::uint32_t version = 1;
+
+	template <typename T>
+	void put(std::ofstream& file, T value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	template <typename T>
+	T get(const char* data)
+	{
+		T value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+}
+
+ResultWriter::ResultWriter(const std::string& path, std::vector<Column> columns, size_t blockRows, bool resume)
+	: schema(std::move(columns)), blockRows(std::max<size_t>(1, blockRows)), block(schema.size())
+{
+	std::error_code error;
+	if (resume && std::filesystem::file_size(path, error) > 0 && !error)
+	{
+		size_t complete;
+		{
+			const ResultTable table(path);
+			const auto& found = table.columns();
+			if (found.size() != schema.size() || !std::equal(found.begin(), found.end(), schema.begin(),
+				[](const Column& a, const Column& b) { return a.name == b.name && a.type == b.type; }))
+				throw std::runtime_error(path + " has other columns than the results written");
+			complete = table.completeSize();
+		}
+		std::filesystem::resize_file(path, complete);
+		file.open(path, std::ios::binary | std::ios::app);
+		if (!file.is_open())
+			throw std::runtime_error("Unable to write results to " + path);
+		return;
+	}
+
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		throw std::runtime_error("Unable to write results to " + path);
+
+	file.write(magic, sizeof(magic));
+	put(file, version);
+	put(file, static_cast<std::uint32_t>(schema.size()));
+	std::uint32_t written = 0;
+	for (const auto& column : schema)
+	{
+		if (column.name.size() > 255)
+			throw std::invalid_argument("Too long name of a column: " + column.name);
+		put(file, static_cast<std::uint8_t>(column.type));
+		put(file, static_cast<std::uint8_t>(column.name.size()));
+		file.write(column.name.data(), column.name.size());
+		written += 2 + static_cast<std::uint32_t>(column.name.size());
+	}
+	for (; written % 4; ++written)
+		put(file, std::uint8_t(0));
+	file.flush();
+}
+
+ResultWriter::~ResultWriter()
+{
+	try
+	{
+		flush();
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << "Results are not saved: " << ex.what() << std::endl;
+	}
+}
+
+void ResultWriter::append(const std::vector<double>& row)
+{
+	if (row.size() != schema.size())
+		throw std::invalid_argument("Row of " + std::to_string(row.size()) + " values for " + std::to_string(schema.size()) + " columns");
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t column = 0; column < schema.size(); ++column)
+	{
+		std::uint32_t bits;
+		if (schema[column].type == ColumnType::INT32)
+		{
+			const std::int32_t value = static_cast<std::int32_t>(row[column]);
+			std::memcpy(&bits, &value, sizeof(bits));
+		}
+		else
+		{
+			const float value = static_cast<float>(row[column]);
+			std::memcpy(&bits, &value, sizeof(bits));
+		}
+		block[column].push_back(bits);
+	}
+	if (block.front().size() >= blockRows)
+		writeBlock();
+}
+
+void ResultWriter::flush()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	writeBlock();
+}
+
+void ResultWriter::writeBlock()
+{
+	if (block.empty() || block.front().empty())
+		return;
+	put(file, static_cast<std::uint32_t>(block.front().size()));
+	for (auto& values : block)
+	{
+		file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(std::uint32_t));
+		values.clear();
+	}
+	file.flush();
+	if (!file)
+		throw std::runtime_error("Unable to write a block of results");
+}
+
+ResultTable::ResultTable(const std::string& path) : file(path)
+{
+	const char* data = file.data();
+	const size_t size = file.size();
+	if (size < sizeof(magic) + 8 || std::memcmp(data, magic, sizeof(magic)))
+		throw std::runtime_error(path + " is not a file of sweep results");
+	if (get<std::uint32_t>(data + 8) != version)
+		throw std::runtime_error("Unknown version of the results in " + path);
+
+	const std::uint32_t columnsCount = get<std::uint32_t>(data + 12);
+	size_t offset = 16;
+	for (std::uint32_t c = 0; c < columnsCount; ++c)
+	{
+		if (offset + 2 > size)
+			throw std::runtime_error("Schema of " + path + " is cut");
+		const auto type = static_cast<ColumnType>(get<std::uint8_t>(data + offset));
+		const size_t nameLength = get<std::uint8_t>(data + offset + 1);
+		if (offset + 2 + nameLength > size)
+			throw std::runtime_error("Schema of " + path + " is cut");
+		schema.push_back(Column{ std::string(data + offset + 2, nameLength), type });
+		offset += 2 + nameLength;
+	}
+	offset = (offset + 3) / 4 * 4;
+	completeBytes = std::min(offset, size);
+
+	while (offset + 4 <= size)
+	{
+		const size_t rows = get<std::uint32_t>(data + offset);
+		const size_t blockSize = 4 + rows * schema.size() * 4;
+		if (offset + blockSize > size)
+			break;
+		blocks.push_back(Block{ rowsCount, rows, data + offset + 4 });
+		rowsCount += rows;
+		offset += blockSize;
+		completeBytes = offset;
+	}
+}
+
+size_t ResultTable::column(const std::string& name) const
+{
+	for (size_t c = 0; c < schema.size(); ++c)
+		if (schema[c].name == name)
+			return c;
+	throw std::runtime_error("No column \"" + name + "\" in the results");
+}
+
+double ResultTable::value(size_t column, size_t row) const
+{
+	const auto block = std::upper_bound(blocks.begin(), blocks.end(), row, [](size_t r, const Block& b) { return r < b.firstRow; }) - 1;
+	const char* bits = block->values + (column * block->rows + row - block->firstRow) * 4;
+	if (schema[column].type == ColumnType::INT32)
+		return get<std::int32_t>(bits);
+	return get<float>(bits);
+}
@@ -0,0 +1,78 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+
+#include "mappedfile.h"
+
+// Append-only columnar store of the sweep results.
+// The file starts with the schema: "SWEEPRES", the version, the number of columns and the type and the name
+// of every column, padded to 4 bytes. Blocks of rows follow: the number of rows, then the values of every
+// column one after another. All the values are 4 bytes, so a mapped block gives a plain array per column.
+// A block cut by a crash is ignored by the reader.
+enum class ColumnType : std::uint8_t { INT32, FLOAT32 };
+
+struct Column
+{
+	std::string name;
+	ColumnType type;
+};
+
+// Writes the rows block by block; append may be called from any thread. With resume the rows go after those
+// of the file if there is one: it must have the same columns, a block cut at its end is dropped
+struct ResultWriter
+{
+	ResultWriter(const std::string& path, std::vector<Column> columns, size_t blockRows = 4096, bool resume = false);
+	~ResultWriter();
+
+	ResultWriter(const ResultWriter&) = delete;
+	ResultWriter& operator=(const ResultWriter&) = delete;
+
+	// One value per column, converted to the type of the column
+	void append(const std::vector<double>& row);
+	// Writes the rows appended so far as a block
+	void flush();
+
+	const std::vector<Column>& columns() const { return schema; }
+
+private:
+	void writeBlock();
+
+	std::vector<Column> schema;
+	size_t blockRows;
+	std::vector<std::vector<std::uint32_t>> block; // bits of the values, by column
+	std::ofstream file;
+	std::mutex mutex;
+};
+
+// Rows of a result file, read in place from the mapped file
+struct ResultTable
+{
+	explicit ResultTable(const std::string& path);
+
+	const std::vector<Column>& columns() const { return schema; }
+	size_t rows() const { return rowsCount; }
+	// Bytes of the schema and the whole blocks, the file without a block cut by a crash
+	size_t completeSize() const { return completeBytes; }
+
+	// Index of the column, throws if there is no such column
+	size_t column(const std::string& name) const;
+	double value(size_t column, size_t row) const;
+
+private:
+	struct Block
+	{
+		size_t firstRow;
+		size_t rows;
+		const char* values;
+	};
+
+	MappedFile file;
+	std::vector<Column> schema;
+	std::vector<Block> blocks;
+	size_t rowsCount = 0;
+	size_t completeBytes = 0;
+};
@@ -0,0 +1,75 @@
+﻿#pragma once
+
+#include "simulation.h"
+#include "sweep.h"
+#include "orders.h"
+
+#include <string>
+#include <vector>
+
+// The vessels of a sweep point as the sweep, the logged runs and the benchmarks set them up
+
+// tows river tugs and tows sea tugs, or only the sea ones working as the river ones without the river tows.
+// Every other tug starts at the loaders, the rest - at the unloaders
+template <typename Recorder>
+void addTows(Simulation<Recorder>& simulation, Fleet<Recorder>& fleet, int tows, int convoy = 1)
+{
+	using TowPtr = typename Simulation<Recorder>::TowPtr;
+	if (simulation.useRiverTows)
+		for (int r = 0; r < tows; ++r)
+		{
+			TowPtr riverTow = fleet.tows.take();
+			riverTow->id = "RIVER TUG #" + std::to_string(r + 1);
+			riverTow->towingVelocity = 4.f / 60;
+			riverTow->movingVelocity = 5.f / 60;
+			riverTow->ballastDraft = 1.4f;
+			riverTow->draftBonus = 0.3f;
+			riverTow->maxBarges = convoy;
+			riverTow->rememberState(r % 2 ? ShipBase::State::LOADING : ShipBase::State::UNLOADING, ShipBase::Cause::TELEPORT);
+			simulation.addTow(riverTow, true);
+		}
+
+	for (int r = 0; r < tows; ++r)
+	{
+		TowPtr seaTug = fleet.tows.take();
+		seaTug->id = (simulation.useRiverTows ? "SEA TUG #" : "TUG #") + std::to_string(r + 1);
+		seaTug->towingVelocity = 5.f / 60;
+		seaTug->movingVelocity = 6.f / 60;
+		seaTug->ballastDraft = 3.75f;
+		seaTug->draftBonus = 0.3f;
+		seaTug->maxBarges = convoy;
+		seaTug->rememberState(r % 2 ? ShipBase::State::LOADING : ShipBase::State::UNLOADING, ShipBase::Cause::TELEPORT);
+		simulation.addTow(seaTug, !simulation.useRiverTows);
+	}
+}
+
+// The barges, then the BTCs, then the RSDs of the point, taken from the fleet.
+// All the vessels of a kind share their orders: their cargo at the loading rate of the point or,
+// if there are any, the orders of the scenario
+template <typename Recorder>
+std::vector<ShipContext<Recorder>> prepareContexts(Fleet<Recorder>& fleet, const SweepPoint& point, const ShipDraftTable::ConstPtr& drafts,
+	const OrderSource::ConstPtr& scenarioOrders = nullptr)
+{
+	std::vector<ShipContext<Recorder>> contexts;
+	const auto add = [&](int count, const std::string& name, float cargo, const auto& take)
+	{
+		const OrderSource::ConstPtr orders = scenarioOrders ? scenarioOrders : std::make_shared<ConstantOrders>(LoadingOrder(cargo, point.intensity));
+		for (int counter = 0; counter < count; ++counter)
+		{
+			ShipContext<Recorder> context;
+			context.ship = take();
+			context.ship->id = name + " #" + std::to_string(counter + 1);
+			context.orders = orders;
+			contexts.push_back(context);
+		}
+	};
+	add(point.bargesNum, "BARGE", point.bargeCargo, [&] { return fleet.washtubs.take(1); });
+	add(point.BTCsNum, "BTC", point.bargeCargo, [&] { return fleet.washtubs.take(2); });
+	add(point.rsdNum, "RSD", point.RSDcargo, [&]
+	{
+		auto rsd = fleet.rsds.take();
+		rsd->setDraftTable(drafts);
+		return rsd;
+	});
+	return contexts;
+}
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include "core.h"
+
+#include <vector>
+#include <algorithm>
+
+// Min-queue of vessels by their next activation time; ties go to the lower index, so the order
+// is the same as the one of a linear scan over the vessels.
+// Clocks of the vessels only go forward and are moved all over the simulation, so instead of
+// being updated on every move an entry is allowed to lag behind: when a stale entry reaches the
+// top it is queued again with the actual time. Every step stays O(log n).
+struct EventScheduler
+{
+	void clear() { heap.clear(); } // keeps the storage for the next run
+	void schedule(size_t index, Timestamp time)
+	{
+		heap.emplace_back(time, index);
+		std::push_heap(heap.begin(), heap.end(), later);
+	}
+	bool empty() const { return heap.empty(); }
+
+	// Index of the vessel with the earliest actual time (timeOf(index) tells it), the entry stays queued
+	template <typename TimeOf>
+	size_t next(TimeOf timeOf)
+	{
+		if (heap.empty())
+			throw std::runtime_error("Nothing is scheduled");
+		for (;;)
+		{
+			const Entry top = heap.front();
+			const Timestamp actual = timeOf(top.second);
+			if (actual == top.first)
+				return top.second;
+			if (actual < top.first)
+				throw std::logic_error("Timer went back for entry #" + std::to_string(top.second));
+			std::pop_heap(heap.begin(), heap.end(), later);
+			heap.back().first = actual;
+			std::push_heap(heap.begin(), heap.end(), later);
+		}
+	}
+
+private:
+	using Entry = std::pair<Timestamp, size_t>;
+	static bool later(const Entry &lhs, const Entry &rhs) { return lhs > rhs; }
+
+	std::vector<Entry> heap; // binary heap with the earliest entry on the front
+};
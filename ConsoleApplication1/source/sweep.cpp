@@ -0,0 +1,110 @@
+﻿#include "stdafx.h"
+
+#include "sweep.h"
+
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <exception>
+
+namespace
+{
+	struct WorkRange
+	{
+		size_t begin = 0;
+		size_t end = 0;
+		std::mutex mutex;
+	};
+
+	bool popFront(WorkRange& range, size_t& index)
+	{
+		std::lock_guard<std::mutex> lock(range.mutex);
+		if (range.begin == range.end)
+			return false;
+		index = range.begin++;
+		return true;
+	}
+
+	bool steal(std::vector<WorkRange>& ranges, size_t thief)
+	{
+		size_t victim = ranges.size();
+		size_t victimSize = 1;
+		for (size_t i = 0; i < ranges.size(); ++i)
+		{
+			if (i == thief)
+				continue;
+			std::lock_guard<std::mutex> lock(ranges[i].mutex);
+			const size_t size = ranges[i].end - ranges[i].begin;
+			if (size > victimSize)
+			{
+				victim = i;
+				victimSize = size;
+			}
+		}
+		if (victim == ranges.size())
+			return false;
+
+		size_t begin, end;
+		{
+			std::lock_guard<std::mutex> lock(ranges[victim].mutex);
+			const size_t size = ranges[victim].end - ranges[victim].begin;
+			if (size < 2) // someone was faster
+				return true;
+			end = ranges[victim].end;
+			begin = ranges[victim].begin + size / 2;
+			ranges[victim].end = begin;
+		}
+		std::lock_guard<std::mutex> lock(ranges[thief].mutex);
+		ranges[thief].begin = begin;
+		ranges[thief].end = end;
+		return true;
+	}
+}
+
+WorkStealingPool::WorkStealingPool(unsigned threads) : threads(std::max(1u, threads))
+{
+}
+
+void WorkStealingPool::forEach(size_t count, const std::function<void(size_t)>& task) const
+{
+	const size_t workersCount = std::min<size_t>(threads, std::max<size_t>(count, 1));
+	std::vector<WorkRange> ranges(workersCount);
+	for (size_t w = 0; w < workersCount; ++w)
+	{
+		ranges[w].begin = count * w / workersCount;
+		ranges[w].end = count * (w + 1) / workersCount;
+	}
+
+	std::mutex errorMutex;
+	std::exception_ptr error;
+	std::atomic<bool> failed{ false };
+	const auto work = [&](size_t worker)
+	{
+		try
+		{
+			size_t index;
+			do
+			{
+				while (!failed && popFront(ranges[worker], index))
+					task(index);
+			} while (!failed && steal(ranges, worker));
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(errorMutex);
+			if (!error)
+				error = std::current_exception();
+			failed = true;
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t w = 1; w < workersCount; ++w)
+		workers.emplace_back(work, w);
+	work(0);
+	for (auto &worker : workers)
+		worker.join();
+
+	if (error)
+		std::rethrow_exception(error);
+}
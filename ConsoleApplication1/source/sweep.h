@@ -0,0 +1,106 @@
+﻿#pragma once
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <algorithm>
+
+struct SweepPoint
+{
+	int tugsNum = 1;
+	int bargesNum = 0;
+	int BTCsNum = 0;
+	int rsdNum = 0;
+
+	float intensity = 0.f;
+	float RSDcargo = 0.f;
+	float bargeCargo = 0.f;
+	float distance = 0.f;
+};
+
+// A (tugs, fleet, intensity) group of a sweep: the grid of RSD cargo x barge cargo x distance,
+// a contiguous slice [begin, end) of the whole sweep in this order
+struct SweepGroup
+{
+	SweepPoint config;
+	std::vector<float> RSDcargos;
+	std::vector<float> bargeCargos;
+	std::vector<float> distances;
+	size_t begin = 0;
+	size_t end = 0;
+
+	size_t size() const { return RSDcargos.size() * bargeCargos.size() * distances.size(); }
+	// Index of the point in the whole sweep
+	size_t indexOf(const std::vector<size_t>& index) const
+	{
+		return begin + (index[0] * bargeCargos.size() + index[1]) * distances.size() + index[2];
+	}
+
+	SweepPoint at(const std::vector<size_t>& index) const
+	{
+		SweepPoint point = config;
+		point.RSDcargo = RSDcargos[index[0]];
+		point.bargeCargo = bargeCargos[index[1]];
+		point.distance = distances[index[2]];
+		return point;
+	}
+	// The point of an index of the whole sweep in [begin, end)
+	SweepPoint at(size_t index) const
+	{
+		const size_t offset = index - begin;
+		return at({ offset / distances.size() / bargeCargos.size(), offset / distances.size() % bargeCargos.size(), offset % distances.size() });
+	}
+};
+
+// The groups of a sweep back to back. The points are made from their indices when they are run,
+// so a sweep of any size takes the memory of its groups only
+struct SweepGrid
+{
+	// Appends the group, its slice starts at the end of the grid
+	void add(SweepGroup group)
+	{
+		group.begin = size();
+		group.end = group.begin + group.size();
+		groups.push_back(std::move(group));
+	}
+
+	size_t size() const { return groups.empty() ? 0 : groups.back().end; }
+	const std::vector<SweepGroup>& all() const { return groups; }
+	const SweepGroup& operator[](size_t group) const { return groups[group]; }
+
+	// The group of an index in [0, size())
+	size_t groupOf(size_t index) const
+	{
+		return std::upper_bound(groups.begin(), groups.end(), index, [](size_t index, const SweepGroup& group) { return index < group.end; }) - groups.begin();
+	}
+	SweepPoint at(size_t index) const { return groups[groupOf(index)].at(index); }
+
+private:
+	std::vector<SweepGroup> groups;
+};
+
+// Work-stealing executor: every worker owns a range of indices and takes them from the front,
+// an idle worker steals the upper half of the largest range left.
+struct WorkStealingPool
+{
+	explicit WorkStealingPool(unsigned threads = std::thread::hardware_concurrency());
+
+	unsigned threadsCount() const { return threads; }
+
+	// Calls task(index) once for every index in [0, count); returns when all of them are done.
+	// The first exception thrown by a task is rethrown here.
+	void forEach(size_t count, const std::function<void(size_t)>& task) const;
+
+private:
+	unsigned threads;
+};
+
+// Evaluates every point in parallel as evaluate(point, index); results are stored by the point index,
+// so the caller can merge them in the original order whatever the number of threads is.
+template <typename Result, typename Evaluate>
+std::vector<Result> runSweep(const std::vector<SweepPoint>& points, Evaluate evaluate, const WorkStealingPool& pool = WorkStealingPool())
+{
+	std::vector<Result> results(points.size());
+	pool.forEach(points.size(), [&](size_t index) { results[index] = evaluate(points[index], index); });
+	return results;
+}
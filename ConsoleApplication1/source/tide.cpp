@@ -0,0 +1,126 @@
+﻿#include "stdafx.h"
+
+#include "tide.h"
+
+#include <cstring>
+
+namespace
+{
+	const char binaryMagic[8] = { 'T', 'I', 'D', 'E', 'D', 'A', 'T', 'A' };
+	const std::uint32_t binaryVersion = 1;
+	// magic, version, step, number of levels
+	const size_t binaryHeaderSize = sizeof(binaryMagic) + 4 + 4 + 8;
+
+	const size_t minutesPerDay = 24 * 60;
+}
+
+bool TideData::readFromFile(const std::string& path)
+{
+	data.clear();
+	step = 60;
+
+	try
+	{
+		const MappedFile file(path);
+		if (file.size() >= sizeof(binaryMagic) && !std::memcmp(file.data(), binaryMagic, sizeof(binaryMagic)))
+			return readBinary(file, path);
+	}
+	catch (const std::runtime_error&)
+	{
+		std::cerr << "Unabe to read file " << path << " - make sure the file exists" << std::endl;
+		return false;
+	}
+	return readText(path);
+}
+
+bool TideData::readText(const std::string& path)
+{
+	TextLines lines(path);
+	std::string_view line;
+	std::vector<float> dayData;
+	size_t levelsPerDay = 0; // taken from the first day
+	int prevDate = 0;
+	while (lines.next(line))
+	{
+		const std::string_view text = line;
+		int date;
+
+		if (!line.size())
+			continue;
+		if (!parseNumber(line, date) || date != prevDate + 1)
+		{
+			std::cerr << "Unable to parse string: \"" << text << "\" - string must begin with a date (expected: " << prevDate + 1 << ")" << std::endl;
+			continue;
+		}
+
+		dayData.clear();
+		float level;
+		while (parseNumber(line, level))
+			dayData.push_back(level);
+		const bool parsed = line.find_first_not_of(" \t") == std::string_view::npos;
+		if (!levelsPerDay && parsed && !dayData.empty() && minutesPerDay % dayData.size() == 0)
+			levelsPerDay = dayData.size();
+
+		if (parsed && levelsPerDay && dayData.size() == levelsPerDay)
+		{
+			data.insert(data.end(), dayData.begin(), dayData.end());
+			++prevDate;
+		}
+		else if (levelsPerDay)
+			std::cerr << "Unable to parse string: \"" << text << "\" - line must have the date and " << levelsPerDay << " values " << std::endl;
+		else
+			std::cerr << "Unable to parse string: \"" << text << "\" - line must have the date and the levels at even steps of the day (24 hourly ones, 144 ones every 10 minutes ...)" << std::endl;
+	}
+	if (levelsPerDay)
+		step = minutesPerDay / levelsPerDay;
+	return true;
+}
+
+bool TideData::readBinary(const MappedFile& file, const std::string& path)
+{
+	std::uint32_t version = 0, fileStep = 0;
+	std::uint64_t count = 0;
+	if (file.size() >= binaryHeaderSize)
+	{
+		std::memcpy(&version, file.data() + 8, sizeof(version));
+		std::memcpy(&fileStep, file.data() + 12, sizeof(fileStep));
+		std::memcpy(&count, file.data() + 16, sizeof(count));
+	}
+	if (version != binaryVersion || !fileStep || file.size() != binaryHeaderSize + count * sizeof(float))
+	{
+		std::cerr << "Unable to read tides from " << path << " - the file is damaged or of another version" << std::endl;
+		return false;
+	}
+	data.resize(static_cast<size_t>(count));
+	std::memcpy(data.data(), file.data() + binaryHeaderSize, data.size() * sizeof(float));
+	step = fileStep;
+	return true;
+}
+
+bool TideData::writeBinary(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		std::cerr << "Unable to write tides to " << path << std::endl;
+		return false;
+	}
+	const std::uint32_t fileStep = static_cast<std::uint32_t>(step);
+	const std::uint64_t count = data.size();
+	file.write(binaryMagic, sizeof(binaryMagic));
+	file.write(reinterpret_cast<const char*>(&binaryVersion), sizeof(binaryVersion));
+	file.write(reinterpret_cast<const char*>(&fileStep), sizeof(fileStep));
+	file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+	file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+	return bool(file);
+}
+
+TideTable::Ptr TideData::toTideTable(float bonus) const
+{
+	TideTable::Ptr table = std::make_shared<TideTable>();
+	table->reserve(data.size());
+	for (size_t counter = 0; counter < data.size(); ++counter)
+		table->add(static_cast<Timestamp>(counter * step), data[counter] + bonus);
+	table->buildPassabilityIndex();
+	return table;
+}
@@ -0,0 +1,214 @@
+﻿#include "stdafx.h"
+
+#include "writer.h"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+	// Yields for a while, then sleeps: how the producer waits for room or for a flush. The writer thread only
+	// yields, once that is spent it blocks until a job comes
+	struct Backoff
+	{
+		static constexpr unsigned yields = 64;
+
+		void wait()
+		{
+			if (++rounds < yields)
+				std::this_thread::yield();
+			else
+				std::this_thread::sleep_for(std::chrono::microseconds(rounds < 1024 ? 50 : 1000));
+		}
+		void reset() { rounds = 0; }
+		bool spent() const { return rounds >= yields; }
+
+		unsigned rounds = 0;
+	};
+}
+
+AsyncWriter::AsyncWriter(size_t capacity) : jobs(capacity), thread([this] { work(); })
+{
+}
+
+AsyncWriter::~AsyncWriter()
+{
+	try
+	{
+		flush();
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << "Files are not saved: " << ex.what() << std::endl;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wakeup.notify_one();
+	thread.join();
+}
+
+void AsyncWriter::write(const std::string &path, std::string text)
+{
+	Job job;
+	job.path = path;
+	job.text = std::move(text);
+	push(std::move(job));
+}
+
+void AsyncWriter::close(const std::string &path)
+{
+	Job job;
+	job.kind = Job::Kind::CLOSE;
+	job.path = path;
+	push(std::move(job));
+}
+
+void AsyncWriter::flush()
+{
+	Job job;
+	job.kind = Job::Kind::CLOSE_ALL;
+	push(std::move(job));
+	for (Backoff backoff; done.load(std::memory_order_acquire) != queued; )
+		backoff.wait();
+	if (error)
+	{
+		const auto failure = error;
+		error = nullptr;
+		std::rethrow_exception(failure);
+	}
+}
+
+void AsyncWriter::push(Job job)
+{
+	for (Backoff backoff; !jobs.push(job); )
+		backoff.wait();
+	++queued;
+	// pairs with the fence of sleep: either the writer thread sees the job or this sees it sleeping
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (sleeping.load(std::memory_order_relaxed))
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		wakeup.notify_one();
+	}
+}
+
+void AsyncWriter::work()
+{
+	Backoff backoff;
+	for (Job job; ; )
+	{
+		if (jobs.pop(job))
+		{
+			backoff.reset();
+			process(job);
+			done.fetch_add(1, std::memory_order_release);
+		}
+		else if (stopping)
+			return;
+		else if (!backoff.spent())
+			backoff.wait();
+		else
+		{
+			sleep();
+			backoff.reset();
+		}
+	}
+}
+
+void AsyncWriter::sleep()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	sleeping.store(true, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	wakeup.wait(lock, [this] { return !jobs.empty() || stopping; });
+	sleeping.store(false, std::memory_order_relaxed);
+}
+
+void AsyncWriter::process(Job &job)
+{
+	try
+	{
+		switch (job.kind)
+		{
+		case Job::Kind::WRITE:
+		{
+			auto file = files.find(job.path);
+			if (file == files.end())
+			{
+				file = files.emplace(job.path, std::ofstream(job.path)).first;
+				if (!file->second.is_open())
+				{
+					files.erase(file);
+					throw std::runtime_error("Unable to write " + job.path);
+				}
+			}
+			file->second.write(job.text.data(), job.text.size());
+			if (!file->second)
+				throw std::runtime_error("Unable to write " + job.path);
+			break;
+		}
+		case Job::Kind::CLOSE:
+		{
+			const auto file = files.find(job.path);
+			if (file == files.end())
+				break;
+			file->second.close();
+			const bool failed = file->second.fail();
+			files.erase(file);
+			if (failed)
+				throw std::runtime_error("Unable to write " + job.path);
+			break;
+		}
+		case Job::Kind::CLOSE_ALL:
+			for (auto &file : files)
+				file.second.close();
+			files.clear();
+			break;
+		}
+	}
+	catch (...)
+	{
+		if (!error)
+			error = std::current_exception();
+	}
+	job = Job();
+}
+
+AsyncWriter::Stream::Stream(AsyncWriter &writer, std::string path, size_t chunkSize)
+	: std::ostream(this), writer(writer), path(std::move(path)), chunk(chunkSize, '\0')
+{
+	setp(&chunk[0], &chunk[0] + chunk.size());
+}
+
+AsyncWriter::Stream::~Stream()
+{
+	handOver();
+	writer.close(path);
+}
+
+AsyncWriter::Stream::int_type AsyncWriter::Stream::overflow(int_type character)
+{
+	handOver();
+	if (traits_type::eq_int_type(character, traits_type::eof()))
+		return traits_type::not_eof(character);
+	*pptr() = traits_type::to_char_type(character);
+	pbump(1);
+	return character;
+}
+
+int AsyncWriter::Stream::sync()
+{
+	handOver();
+	return 0;
+}
+
+void AsyncWriter::Stream::handOver()
+{
+	if (pptr() == pbase())
+		return;
+	writer.write(path, std::string(pbase(), pptr()));
+	setp(&chunk[0], &chunk[0] + chunk.size());
+}
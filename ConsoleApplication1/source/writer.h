@@ -0,0 +1,113 @@
+﻿#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Ring of a fixed capacity for one producer thread and one consumer thread: push and pop never lock
+// and never wait, they fail when the ring is full or empty
+template <typename T>
+struct SpscRing
+{
+	explicit SpscRing(size_t capacity) : slots(capacity + 1) {}
+
+	bool push(T &value)
+	{
+		const size_t position = tail.load(std::memory_order_relaxed);
+		const size_t next = (position + 1) % slots.size();
+		if (next == head.load(std::memory_order_acquire))
+			return false;
+		slots[position] = std::move(value);
+		tail.store(next, std::memory_order_release);
+		return true;
+	}
+	bool pop(T &value)
+	{
+		const size_t position = head.load(std::memory_order_relaxed);
+		if (position == tail.load(std::memory_order_acquire))
+			return false;
+		value = std::move(slots[position]);
+		head.store((position + 1) % slots.size(), std::memory_order_release);
+		return true;
+	}
+	// Called by the consumer
+	bool empty() const { return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire); }
+
+private:
+	std::vector<T> slots; // one is always empty to tell a full ring from an empty one
+	alignas(64) std::atomic<size_t> head{ 0 }; // the next slot to pop
+	alignas(64) std::atomic<size_t> tail{ 0 }; // the next slot to push
+};
+
+// Writes the files on a thread of its own. The thread calling write and close - always the same one - hands
+// the text over and goes on; it waits only while capacity buffers are queued, so the memory stays bounded.
+// The files are written in the order of the calls; the first write to a path truncates the file, the next
+// ones append to it until it is closed
+struct AsyncWriter
+{
+	explicit AsyncWriter(size_t capacity = 64);
+	// Flushes, the errors are printed
+	~AsyncWriter();
+
+	AsyncWriter(const AsyncWriter&) = delete;
+	AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+	void write(const std::string &path, std::string text);
+	void close(const std::string &path);
+	// Waits until everything queued is written and the files are closed; throws the first error of the writer
+	void flush();
+
+	// A file written through the writer in chunks of chunkSize, closed when the stream is destroyed
+	struct Stream;
+
+private:
+	struct Job
+	{
+		enum class Kind { WRITE, CLOSE, CLOSE_ALL } kind = Kind::WRITE;
+		std::string path;
+		std::string text;
+	};
+
+	void push(Job job);
+	void work();
+	// Blocks the writer thread until a job is pushed or the writer stops
+	void sleep();
+	void process(Job &job);
+
+	SpscRing<Job> jobs;
+	size_t queued = 0; // jobs pushed by the producer
+	std::atomic<size_t> done{ 0 }; // jobs processed by the writer thread
+	std::atomic<bool> stopping{ false };
+	std::atomic<bool> sleeping{ false }; // the writer thread is blocked or about to be: push wakes it
+	std::mutex mutex; // guards the sleep of the writer thread only, the jobs never wait for it
+	std::condition_variable wakeup;
+	std::exception_ptr error; // the first one, set by the writer thread before done gets to the failed job
+	std::map<std::string, std::ofstream> files; // open files, used by the writer thread only
+	std::thread thread;
+};
+
+struct AsyncWriter::Stream : private std::streambuf, public std::ostream
+{
+	Stream(AsyncWriter &writer, std::string path, size_t chunkSize = 1 << 16);
+	~Stream();
+
+private:
+	using int_type = std::streambuf::int_type;
+	using traits_type = std::streambuf::traits_type;
+
+	int_type overflow(int_type character) override;
+	int sync() override;
+	void handOver();
+
+	AsyncWriter &writer;
+	std::string path;
+	std::string chunk;
+};
@@ -0,0 +1,61 @@
+﻿#include "orders.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// The order sources: a pattern starts over, a schedule ends, both read what the file has. Fails with a message
+int main()
+{
+	int failures = 0;
+	const auto check = [&](bool passed, const std::string& what)
+	{
+		if (!passed)
+		{
+			std::cerr << "FAILED: " << what << std::endl;
+			++failures;
+		}
+	};
+	const auto same = [](const LoadingOrder& lhs, const LoadingOrder& rhs)
+	{
+		return lhs.loadCargo == rhs.loadCargo && lhs.loadIntensity == rhs.loadIntensity;
+	};
+
+	const std::vector<LoadingOrder> pattern{ LoadingOrder(3000.f, 25.f), LoadingOrder(6000.f, 30.f), LoadingOrder(4500.f, 20.f) };
+
+	const CyclicOrders cyclic(pattern);
+	LoadingOrder order;
+	for (size_t index = 0; index < 3 * pattern.size(); ++index)
+		check(cyclic.get(index, order) && same(order, pattern[index % pattern.size()]), "the pattern repeats at order " + std::to_string(index));
+
+	ScheduledOrders schedule;
+	for (const auto& scheduled : pattern)
+		schedule.add(scheduled);
+	for (size_t index = 0; index < pattern.size(); ++index)
+		check(schedule.get(index, order) && same(order, pattern[index]), "the schedule gives order " + std::to_string(index));
+	check(!schedule.get(pattern.size(), order) && !schedule.get(pattern.size() + 1, order), "the schedule ends after its last order");
+
+	const std::string path = "orders_check.txt";
+	{
+		std::ofstream file(path);
+		file << "3000 1500\n\n6000 1800\n4500 1200\n";
+	}
+	ScheduledOrders read;
+	check(read.readFromFile(path) && read.size() == pattern.size(), "the file has all the orders");
+	for (size_t index = 0; index < read.size(); ++index)
+		check(read.get(index, order) && same(order, pattern[index]), "the file gives order " + std::to_string(index));
+	std::remove(path.c_str());
+
+	Fnv1a cyclicKey, scheduleKey, readKey;
+	cyclic.hashInto(cyclicKey);
+	schedule.hashInto(scheduleKey);
+	read.hashInto(readKey);
+	check(cyclicKey.value != scheduleKey.value, "a pattern and a schedule of the same orders have other keys");
+	check(scheduleKey.value == readKey.value, "a schedule read from a file has the key of the same orders");
+
+	if (!failures)
+		std::cerr << "The order sources are fine" << std::endl;
+	return failures ? 1 : 0;
+}